@@ -11,9 +11,20 @@
 #include <Mahi/Robo/Mechatronics/ForceSensor.hpp>
 #include <Mahi/Robo/Mechatronics/TorqueSensor.hpp>
 
+#include <Mahi/Robo/Trajectories/BatchEvaluator.hpp>
 #include <Mahi/Robo/Trajectories/DynamicMotionPrimitive.hpp>
+#include <Mahi/Robo/Trajectories/FixedMinimumJerk.hpp>
+#include <Mahi/Robo/Trajectories/FixedTrajectory.hpp>
 #include <Mahi/Robo/Trajectories/MinimumJerk.hpp>
+#include <Mahi/Robo/Trajectories/MinimumJerkSpline.hpp>
+#include <Mahi/Robo/Trajectories/OnlineTrajectoryGenerator.hpp>
+#include <Mahi/Robo/Trajectories/RetimedTrajectory.hpp>
+#include <Mahi/Robo/Trajectories/StreamingTrajectory.hpp>
 #include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Robo/Trajectories/TrajectoryFile.hpp>
+#include <Mahi/Robo/Trajectories/TrajectoryIndex.hpp>
+#include <Mahi/Robo/Trajectories/TrajectoryView.hpp>
+#include <Mahi/Robo/Trajectories/VelocityProfile.hpp>
 #include <Mahi/Robo/Trajectories/WayPoint.hpp>
 
 #include <Mahi/Robo/Types.hpp>
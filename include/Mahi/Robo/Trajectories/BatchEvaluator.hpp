@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Samples many trajectories over a common time grid on a persistent pool of
+    /// threads. Each call splits the work into chunks of rows, deals them out to
+    /// per-thread queues, and lets idle threads steal from the back of busy
+    /// threads' queues, so uneven trajectory lengths still keep every core busy.
+    /// The calling thread takes part in the work, and one batch runs at a time,
+    /// so sample_many() must not be called from several threads at once.
+    class BatchEvaluator {
+
+    public:
+        /// Constructor. #num_threads includes the calling thread; 0 uses all
+        /// hardware threads.
+        explicit BatchEvaluator(std::size_t num_threads = 0);
+
+        /// Destructor. Stops and joins the pool threads.
+        ~BatchEvaluator();
+
+        /// Samples each of #trajectories at #instants into the matching matrix of
+        /// #outputs, which must already be instants.size() x get_dim() of its
+        /// trajectory. Returns false without writing anything if an output has
+        /// the wrong size, a trajectory is empty, or a cubic #interp_method has not
+        /// been prepared on every trajectory; see Trajectory::prepare().
+        bool sample_many(const std::vector<const Trajectory *> &trajectories,
+                         const std::vector<mahi::util::Time> &instants,
+                         std::vector<Trajectory::PositionMatrix> &outputs,
+                         Trajectory::Interp interp_method = Trajectory::Interp::Linear);
+
+        /// sample_many() over a vector of trajectories
+        bool sample_many(const std::vector<Trajectory> &trajectories,
+                         const std::vector<mahi::util::Time> &instants,
+                         std::vector<Trajectory::PositionMatrix> &outputs,
+                         Trajectory::Interp interp_method = Trajectory::Interp::Linear);
+
+        /// Returns the number of threads that evaluate, including the caller
+        std::size_t num_threads() const;
+
+    private:
+        BatchEvaluator(const BatchEvaluator &) = delete;
+        BatchEvaluator &operator=(const BatchEvaluator &) = delete;
+
+        /// Rows [begin, end) of the output of one trajectory
+        struct Task {
+            std::size_t trajectory;
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        /// Task queue owned by one thread and open to stealing by the others
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        /// Pool thread body: waits for a batch and works on it
+        void worker(std::size_t index);
+
+        /// Runs tasks from queue #index, then steals from the others until none are left
+        void work(std::size_t index);
+
+        /// Takes a task from the front of queue #index or the back of another queue
+        bool next_task(std::size_t index, Task &task);
+
+    private:
+        std::size_t num_threads_; // evaluating threads, including the caller
+
+        std::unique_ptr<Queue[]> queues_; // one task queue per evaluating thread
+
+        std::vector<std::thread> threads_; // pool threads, num_threads_ - 1 of them
+
+        std::mutex mutex_;                 // guards the batch state below
+        std::condition_variable start_cv_; // signals pool threads that a batch is ready
+        std::condition_variable done_cv_;  // signals the caller that a pool thread finished
+        std::size_t batch_;                // number of batches started
+        std::size_t running_;              // pool threads still working on the batch
+        bool stop_;                        // tells the pool threads to exit
+
+        const std::vector<const Trajectory *> *trajectories_; // trajectories of the current batch
+        const std::vector<mahi::util::Time> *instants_;       // instants of the current batch
+        std::vector<Trajectory::PositionMatrix> *outputs_;    // outputs of the current batch
+        Trajectory::Interp interp_method_;                    // interpolation of the current batch
+    };
+
+}  // namespace robo
+}  // namespace mahi
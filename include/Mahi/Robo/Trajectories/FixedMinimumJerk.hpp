@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/FixedTrajectory.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <cstdint>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// MinimumJerk whose dimension N is fixed at compile time. The rest-to-rest
+    /// quintic is evaluated in closed form, so at_time() can be called directly
+    /// from a control loop without materializing the trajectory.
+    template <int N>
+    class FixedMinimumJerk {
+
+    public:
+        typedef Eigen::Matrix<double, N, 1> Vector;
+
+    public:
+        /// Constructor
+        FixedMinimumJerk(const mahi::util::Time &sample_period, const FixedWayPoint<N> &start,
+                         const FixedWayPoint<N> &goal) :
+            Ts_(sample_period), T_(0.0)
+        {
+            set_endpoints(start, goal);
+        }
+
+        /// Sets the start point and goal point and regenerates the trajectory.
+        /// Returns true if successful.
+        bool set_endpoints(const FixedWayPoint<N> &start, const FixedWayPoint<N> &goal) {
+            if (goal.when() <= start.when()) {
+                LOG(Warning) << "Goal WayPoint must be at a time after start WayPoint. Parameters not set. (" << goal.when() << " !<= " << start.when() << ")";
+                return false;
+            }
+            q_0_ = start;
+            g_ = goal;
+            const std::int64_t duration = (g_.when() - q_0_.when()).as_microseconds();
+            const std::int64_t period = Ts_.as_microseconds();
+            if (period > 0 && duration % period != 0) {
+                g_.set_time(q_0_.when() + mahi::util::microseconds(duration - duration % period));
+                LOG(Warning) << "Trajectory duration not evenly divisible by sample period. Shortening trajectory duration.";
+            }
+            T_ = (g_.when() - q_0_.when()).as_seconds();
+            generate_trajectory();
+            return true;
+        }
+
+        /// Writes the position, velocity and acceleration at #instant. Holds the
+        /// end points outside of the movement.
+        void at_time(const mahi::util::Time &instant, Vector &position, Vector &velocity,
+                     Vector &acceleration) const {
+            const Vector D = g_.get_pos() - q_0_.get_pos();
+            if (T_ <= 0.0) {
+                position = q_0_.get_pos();
+                velocity.setZero();
+                acceleration.setZero();
+                return;
+            }
+            double s = (instant - q_0_.when()).as_seconds() / T_;
+            s = s < 0.0 ? 0.0 : (s > 1.0 ? 1.0 : s);
+            const double s2 = s * s;
+            position = q_0_.get_pos() + (s2 * s * (10.0 + s * (-15.0 + s * 6.0))) * D;
+            velocity = (s2 * (30.0 + s * (-60.0 + s * 30.0)) / T_) * D;
+            acceleration = (s * (60.0 + s * (-180.0 + s * 120.0)) / (T_ * T_)) * D;
+        }
+
+        /// Returns the position at #instant
+        Vector at_time(const mahi::util::Time &instant) const {
+            Vector position, velocity, acceleration;
+            at_time(instant, position, velocity, acceleration);
+            return position;
+        }
+
+        /// Returns the trajectory sampled every sample period
+        const FixedTrajectory<N> &trajectory() const { return trajectory_; }
+
+    private:
+        /// Samples the movement into trajectory_
+        void generate_trajectory() {
+            trajectory_.clear();
+            const std::int64_t period = Ts_.as_microseconds();
+            const std::size_t path_size = period > 0 ? static_cast<std::size_t>((g_.when() - q_0_.when()).as_microseconds() / period) + 1 : 1;
+            trajectory_.reserve(path_size);
+            Vector position, velocity, acceleration;
+            for (std::size_t i = 0; i < path_size; ++i) {
+                const mahi::util::Time t = q_0_.when() + mahi::util::microseconds(static_cast<std::int64_t>(i) * Ts_.as_microseconds());
+                at_time(t, position, velocity, acceleration);
+                trajectory_.push_back(t, position);
+            }
+        }
+
+    private:
+        mahi::util::Time Ts_; // sample period
+        double T_;            // total movement time [s]
+        FixedWayPoint<N> q_0_; // starting point
+        FixedWayPoint<N> g_;   // goal point
+
+        FixedTrajectory<N> trajectory_; // trajectory sampled every Ts_
+
+    public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
+}  // namespace robo
+}  // namespace mahi
@@ -0,0 +1,258 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Robo/Trajectories/WayPoint.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// WayPoint whose dimension N is fixed at compile time. The position is a
+    /// fixed-size Eigen vector, so it lives inline and per-dimension loops over
+    /// it are unrolled by the compiler.
+    template <int N>
+    class FixedWayPoint {
+
+    public:
+        typedef Eigen::Matrix<double, N, 1> Vector;
+
+    public:
+        /// Constructor
+        FixedWayPoint() : time_(mahi::util::Time::Zero), pos_(Vector::Zero()) {}
+        FixedWayPoint(const mahi::util::Time &time, const Vector &position) :
+            time_(time), pos_(position) {}
+
+        const mahi::util::Time &when() const { return time_; }
+
+        /// Returns the position vector
+        const Vector &get_pos() const { return pos_; }
+
+        /// Read access to position
+        const double &operator[](std::size_t index) const { return pos_[index]; }
+
+        /// Write access to position
+        double &operator[](std::size_t index) { return pos_[index]; }
+
+        void set_time(const mahi::util::Time &time) { time_ = time; }
+
+        void set_pos(const Vector &pos) { pos_ = pos; }
+
+        /// Returns the path dimension
+        static std::size_t get_dim() { return N; }
+
+        /// Converts to a runtime-dimension WayPoint
+        WayPoint to_waypoint() const { return WayPoint(time_, pos_.data(), N); }
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    private:
+        mahi::util::Time time_; // time of the waypoint
+
+        Vector pos_; // position of the waypoint
+    };
+
+    /// Trajectory whose dimension N is fixed at compile time. Positions are stored
+    /// as fixed-size Eigen vectors, so interpolation compiles to straight-line
+    /// vector code with no runtime dimension checks. Interpolation is linear;
+    /// convert to a Trajectory with to_trajectory() for the cubic methods.
+    template <int N>
+    class FixedTrajectory {
+
+    public:
+        typedef Eigen::Matrix<double, N, 1> Vector;
+
+    public:
+        /// Constructor
+        FixedTrajectory() : uniform_(false), sample_period_(0.0) {}
+
+        /// Constructs from a runtime-dimension Trajectory, which must have dimension N
+        explicit FixedTrajectory(const Trajectory &trajectory) : uniform_(false), sample_period_(0.0) {
+            if (trajectory.get_dim() != static_cast<std::size_t>(N)) {
+                LOG(Warning) << "Trajectory given to FixedTrajectory has wrong dimension. Trajectory not copied.";
+                return;
+            }
+            reserve(trajectory.size());
+            Eigen::Map<const Trajectory::PositionMatrix> positions = trajectory.positions();
+            for (std::size_t i = 0; i < trajectory.size(); ++i) {
+                push_back(trajectory.times()[i], positions.row(i).transpose());
+            }
+        }
+
+        /// Writes the linearly interpolated position at #instant into #position.
+        /// Holds the end points outside of the time range. Returns false if empty.
+        bool at_time(const mahi::util::Time &instant, Vector &position) const {
+            std::size_t cursor = 0;
+            return at_time(instant, cursor, position);
+        }
+
+        /// at_time() with a playback cursor; see Trajectory::at_time()
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor, Vector &position) const {
+            Vector velocity, acceleration;
+            return evaluate(instant, cursor, position, velocity, acceleration);
+        }
+
+        /// Writes the position, velocity and acceleration at #instant from a single
+        /// segment lookup
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor, Vector &position,
+                     Vector &velocity, Vector &acceleration) const {
+            return evaluate(instant, cursor, position, velocity, acceleration);
+        }
+
+        /// Returns the position at #instant
+        Vector at_time(const mahi::util::Time &instant) const {
+            Vector position = Vector::Zero();
+            at_time(instant, position);
+            return position;
+        }
+
+        /// Returns the waypoint at #index
+        FixedWayPoint<N> operator[](std::size_t index) const {
+            return FixedWayPoint<N>(times_[index], positions_[index]);
+        }
+
+        /// Adds a single waypoint to the end of the list. Returns false if its
+        /// time is before the last waypoint.
+        bool push_back(const mahi::util::Time &time, const Vector &position) {
+            if (!times_.empty() && time < times_.back()) {
+                LOG(Warning) << "Input waypoint times must be monotonically increasing or not changing. Waypoint not added.";
+                return false;
+            }
+            if (times_.size() == 1) {
+                sample_period_ = (time - times_.front()).as_seconds();
+                uniform_ = sample_period_ > 0.0;
+            }
+            else if (uniform_ && std::abs((time - times_.front()).as_seconds() - times_.size() * sample_period_) > 2e-6) {
+                uniform_ = false;
+            }
+            times_.push_back(time);
+            positions_.push_back(position);
+            return true;
+        }
+
+        bool push_back(const FixedWayPoint<N> &waypoint) {
+            return push_back(waypoint.when(), waypoint.get_pos());
+        }
+
+        /// Reserves storage for #n waypoints
+        void reserve(std::size_t n) {
+            times_.reserve(n);
+            positions_.reserve(n);
+        }
+
+        /// Returns the times of all waypoints
+        const std::vector<mahi::util::Time> &times() const { return times_; }
+
+        /// Returns whether or not the waypoints are uniformly spaced in time
+        bool is_uniform() const { return uniform_; }
+
+        /// Returns whether or not the trajectory is empty, having no points
+        bool empty() const { return times_.empty(); }
+
+        /// Returns the number of waypoints
+        std::size_t size() const { return times_.size(); }
+
+        /// Returns the path dimension
+        static std::size_t get_dim() { return N; }
+
+        /// Clears the waypoints, setting the trajectory to empty
+        void clear() {
+            times_.clear();
+            positions_.clear();
+            uniform_ = false;
+            sample_period_ = 0.0;
+        }
+
+        /// Converts to a runtime-dimension Trajectory
+        Trajectory to_trajectory(Trajectory::Interp interp_method = Trajectory::Interp::Linear) const {
+            Trajectory::PositionMatrix positions(size(), N);
+            for (std::size_t i = 0; i < size(); ++i) {
+                positions.row(i) = positions_[i].transpose();
+            }
+            return Trajectory(times_, positions, interp_method);
+        }
+
+    private:
+        /// Locates the segment containing #instant and interpolates it
+        bool evaluate(const mahi::util::Time &instant, std::size_t &cursor, Vector &position,
+                      Vector &velocity, Vector &acceleration) const {
+            if (times_.empty()) {
+                return false;
+            }
+            acceleration.setZero();
+            if (instant <= times_.front() || times_.size() == 1) {
+                cursor = 0;
+                position = positions_.front();
+                velocity.setZero();
+                return true;
+            }
+            if (instant >= times_.back()) {
+                cursor = times_.size() - 1;
+                position = positions_.back();
+                velocity.setZero();
+                return true;
+            }
+            std::size_t after;
+            if (uniform_) {
+                after = static_cast<std::size_t>(std::ceil((instant - times_.front()).as_seconds() / sample_period_));
+                after = std::max<std::size_t>(1, std::min(after, times_.size() - 1));
+                while (after > 1 && times_[after - 1] >= instant) --after;
+                while (times_[after] < instant) ++after;
+            }
+            else if (cursor > 0 && cursor < times_.size() && times_[cursor - 1] < instant && times_[cursor] >= instant) {
+                after = cursor;
+            }
+            else if (cursor + 1 < times_.size() && times_[cursor] < instant && times_[cursor + 1] >= instant) {
+                after = cursor + 1;
+            }
+            else {
+                after = static_cast<std::size_t>(std::lower_bound(times_.begin(), times_.end(), instant) - times_.begin());
+            }
+            cursor = after;
+            const std::size_t before = after - 1;
+            const double dt = (times_[after] - times_[before]).as_seconds();
+            if (dt <= 0.0) {
+                position = positions_[after];
+                velocity.setZero();
+                return true;
+            }
+            velocity = (positions_[after] - positions_[before]) / dt;
+            position = positions_[before] + (instant - times_[before]).as_seconds() * velocity;
+            return true;
+        }
+
+    private:
+        std::vector<mahi::util::Time> times_; // times of the waypoints
+
+        std::vector<Vector, Eigen::aligned_allocator<Vector>> positions_; // positions of the waypoints
+
+        bool uniform_; // whether or not times_ is uniformly spaced by sample_period_
+
+        double sample_period_; // spacing of times_ in seconds when uniform_ is true
+    };
+
+}  // namespace robo
+}  // namespace mahi
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <vector>
+#include <Eigen/Dense>
 #include <Mahi/Util/Math/Integrator.hpp>
 #include <Mahi/Util/Timing/Time.hpp>
 #include <Mahi/Robo/Trajectories/Trajectory.hpp>
@@ -33,9 +34,27 @@ namespace robo {
 		/// Constructor without nonlinear function
 		MinimumJerk(const mahi::util::Time &sample_period, const WayPoint &start, const WayPoint &goal);
 
-		/// Returns the trajectory generated by the DMP
+		/// Returns the trajectory sampled every sample period. The samples are
+		/// only computed on the first call after the endpoints change.
 		const Trajectory& trajectory();
 
+		/// Returns the position at #instant, holding the endpoints outside of the
+		/// movement
+		std::vector<double> at_time(const mahi::util::Time &instant) const;
+
+		/// Writes the position at #instant into #position, which must be of size
+		/// get_dim(). Evaluates the quintic directly, without sampling the trajectory.
+		bool at_time(const mahi::util::Time &instant, Eigen::Ref<Eigen::VectorXd> position) const;
+
+		/// Writes the position, velocity, acceleration and jerk at #instant, each of
+		/// which must be of size get_dim()
+		bool at_time(const mahi::util::Time &instant, Eigen::Ref<Eigen::VectorXd> position,
+			Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration,
+			Eigen::Ref<Eigen::VectorXd> jerk) const;
+
+		/// Returns the path dimension
+		std::size_t get_dim() const;
+
 		/// Updates the trajectory of the DMP based on the new value of theta
 		const Trajectory& update();
 
@@ -51,6 +70,39 @@ namespace robo {
 		/// Sets the start point and goal point and regenerates the trajectory. Returns true if successful.
 		bool set_endpoints(const WayPoint &start, const WayPoint &goal);
 
+		/// Sets the start point and a goal position reached as soon as the per-dimension
+		/// limits allow, and regenerates the trajectory. The duration comes from
+		/// shortest_duration() with the sample period. Returns true if successful.
+		bool set_endpoints(const WayPoint &start, const std::vector<double> &goal, const std::vector<double> &max_velocity,
+			const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk);
+
+		/// Returns the shortest duration of a movement from #start to #goal that keeps
+		/// every dimension within its velocity, acceleration and jerk limits, rounded up
+		/// to a multiple of #sample_period if one is given. All dimensions share the
+		/// duration, so the one that needs the longest sets it. From the peaks of the
+		/// rest-to-rest quintic over a distance D, 15D/(8T), 10D/(sqrt(3)T^2) and 60D/T^3,
+		/// each limit gives a lower bound on T in closed form. A limit of INF is ignored.
+		/// Returns Time::Zero if the inputs are inconsistent.
+		static mahi::util::Time shortest_duration(const std::vector<double> &start, const std::vector<double> &goal,
+			const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration,
+			const std::vector<double> &max_jerk, const mahi::util::Time &sample_period = mahi::util::Time::Zero);
+
+		/// Restarts the movement at #now from the given #position, #velocity and
+		/// #acceleration, e.g. the current state of the robot, toward #goal, which is
+		/// reached at rest. Only the coefficients are recomputed, so this is O(dim)
+		/// and can be called every control tick to retarget a moving goal without
+		/// a jump in position, velocity or acceleration. The movement takes exactly
+		/// the time left until #goal, which need not be a multiple of the sample
+		/// period. Returns false, without logging, once #goal is no longer after
+		/// #now, in which case the previous plan is kept and holds its goal.
+		bool replan(const mahi::util::Time &now, const Eigen::Ref<const Eigen::VectorXd> &position,
+			const Eigen::Ref<const Eigen::VectorXd> &velocity, const Eigen::Ref<const Eigen::VectorXd> &acceleration,
+			const WayPoint &goal);
+
+		/// Sets the sample period, which must be positive and no longer than the
+		/// movement, and regenerates the trajectory. Returns true if successful.
+		bool set_sample_period(const mahi::util::Time &sample_period);
+
 		/// Sets the interp_method and max_diff properties of the trajectory.
 		void set_trajectory_params(Trajectory::Interp interp_method = Trajectory::Interp::Linear, const std::vector<double> &max_diff = { mahi::util::INF });
 
@@ -62,12 +114,22 @@ namespace robo {
 		/// Checks that input parameters start, goal, K, and D all have dimensions that are consistent
 		bool check_param_dim();
 
-		/// Sets the parameter tau based on given waypoints and generates a vector of waypoint times for the trajectory
+		/// shortest_duration() for the #dim start positions at #start
+		static mahi::util::Time shortest_duration(const double *start, std::size_t dim, const std::vector<double> &goal,
+			const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration,
+			const std::vector<double> &max_jerk, const mahi::util::Time &sample_period);
+
+		/// Sets the parameter tau and the number of samples based on given waypoints
 		void set_timing_parameters();
 
-		/// Generate trajectory from given parameters
+		/// Computes the quintic coefficients from the endpoints and starting velocity
+		/// and acceleration
 		void generate_trajectory();
 
+		/// Evaluates the quintic at #instant into the non-null outputs
+		void evaluate(const mahi::util::Time &instant, double *position, double *velocity,
+			double *acceleration, double *jerk) const;
+
 
 	private:
 
@@ -77,15 +139,21 @@ namespace robo {
 		double T_; // total movement time
 		WayPoint q_0_; // starting point
 		WayPoint g_; // goal point
+		std::vector<double> v_0_; // starting velocity
+		std::vector<double> a_0_; // starting acceleration
 
 		double tau_; // temporal scaling factor ensuring arrival at the goal
 
 		std::size_t path_dim_; // dimensionality of the trajectory
 		std::size_t path_size_; // number of waypoints in the trajectory
-		std::vector<double> times_; // vector of times associated with trajectory waypoints
-		std::size_t current_time_idx_; // index for tracking generation of trajectory
 
-		Trajectory trajectory_; // trajectory generated upon construction or update of feature weighting vector theta
+		std::vector<double> coeffs_; // quintic coefficients in powers of time since start, 6 per dimension
+
+		Trajectory trajectory_; // trajectory sampled from coeffs_ on demand
+		bool sampled_; // whether or not trajectory_ matches the current coefficients
+
+		Trajectory::Interp interp_method_; // interpolation method of trajectory_
+		std::vector<double> max_diff_; // max_diff of trajectory_
 
 	};
 
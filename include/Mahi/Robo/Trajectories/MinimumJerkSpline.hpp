@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Robo/Trajectories/WayPoint.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Minimum-jerk path through a sequence of timed via-points, starting and
+    /// ending at rest. The path is a quintic per segment that passes through
+    /// every via-point with continuous velocity, acceleration, jerk and snap,
+    /// which is the minimum-jerk solution for the given times. The velocities
+    /// and accelerations at the interior via-points come from one 2x2
+    /// block-tridiagonal solve shared by all dimensions, so planning is
+    /// O(via-points x dim). Like MinimumJerk, the path is evaluated directly from
+    /// the coefficients and only sampled into a Trajectory on request.
+    class MinimumJerkSpline {
+
+    public:
+        /// Constructor
+        MinimumJerkSpline();
+        MinimumJerkSpline(const mahi::util::Time &sample_period, const std::vector<WayPoint> &waypoints);
+
+        /// Plans the path through #waypoints, which must number at least two, share
+        /// a dimension, and be strictly increasing in time. Returns true if successful.
+        bool set_waypoints(const std::vector<WayPoint> &waypoints);
+
+        /// Sets the period at which trajectory() samples the path
+        void set_sample_period(const mahi::util::Time &sample_period);
+
+        /// Sets the interp_method and max_diff properties of the sampled trajectory
+        void set_trajectory_params(Trajectory::Interp interp_method = Trajectory::Interp::Linear,
+                                   const std::vector<double> &max_diff = { mahi::util::INF });
+
+        /// Returns the path sampled every sample period from the first to the last
+        /// via-point. The samples are only computed on the first call after the
+        /// path changes.
+        const Trajectory &trajectory();
+
+        /// Returns the position at #instant, holding the end points outside of the path
+        std::vector<double> at_time(const mahi::util::Time &instant) const;
+
+        /// Writes the position at #instant into #position, which must be of size
+        /// get_dim(). #cursor holds the segment of the previous query, so sweeping
+        /// forward in time finds each segment in O(1).
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position) const;
+
+        /// Writes the position, velocity, acceleration and jerk at #instant, each of
+        /// which must be of size get_dim()
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position,
+                     Eigen::Ref<Eigen::VectorXd> velocity,
+                     Eigen::Ref<Eigen::VectorXd> acceleration,
+                     Eigen::Ref<Eigen::VectorXd> jerk) const;
+
+        /// Returns the number of via-points
+        std::size_t size() const;
+
+        /// Returns whether or not a path has been planned
+        bool empty() const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+        /// Clears the path
+        void clear();
+
+    private:
+        /// Solves for the interior velocities and accelerations and fills coeffs_
+        void plan(const std::vector<WayPoint> &waypoints);
+
+        /// Returns the segment containing #instant, starting the search from #cursor
+        std::size_t find_segment(const mahi::util::Time &instant, std::size_t cursor) const;
+
+        /// Evaluates the path at #instant into the non-null outputs
+        void evaluate(const mahi::util::Time &instant, std::size_t &cursor, double *position,
+                      double *velocity, double *acceleration, double *jerk) const;
+
+    private:
+        mahi::util::Time Ts_; // sample period of trajectory()
+
+        std::size_t path_dim_; // dimensionality of the path
+
+        std::vector<mahi::util::Time> times_; // via-point times
+
+        std::vector<double> coeffs_; // quintic coefficients in powers of time since the segment start, 6 x path_dim_ per segment
+
+        Trajectory trajectory_; // trajectory sampled from coeffs_ on demand
+        bool sampled_;          // whether or not trajectory_ matches the current coefficients
+
+        Trajectory::Interp interp_method_; // interpolation method of trajectory_
+        std::vector<double> max_diff_;     // max_diff of trajectory_
+    };
+
+}  // namespace robo
+}  // namespace mahi
@@ -0,0 +1,102 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Tracks a streaming target, e.g. a slider, teleoperation or vision setpoint,
+    /// with a smooth state that respects per-dimension velocity, acceleration and
+    /// jerk limits. Each call to update() advances the state by one sample period
+    /// along the time-optimal trajectory toward the latest target: every dimension
+    /// drives toward the target as fast as the limits allow until the closed-form
+    /// jerk-limited braking profile would stop it right on the target, and then
+    /// brakes along that profile. The state is sampled from this trajectory, so the
+    /// velocity, acceleration and jerk stay within their limits throughout, and a
+    /// target that holds still is reached exactly, without overshoot whenever the
+    /// state can still stop in time. An update is O(dim) and does not allocate, so
+    /// it is safe to call from a control loop.
+    class OnlineTrajectoryGenerator {
+
+    public:
+        /// Constructor. The state starts at rest at the origin until reset().
+        OnlineTrajectoryGenerator(const mahi::util::Time &sample_period,
+                                  const std::vector<double> &max_velocity,
+                                  const std::vector<double> &max_acceleration,
+                                  const std::vector<double> &max_jerk);
+
+        /// Sets the limits, which must all be positive and of size get_dim().
+        /// Returns true if successful.
+        bool set_limits(const std::vector<double> &max_velocity,
+                        const std::vector<double> &max_acceleration,
+                        const std::vector<double> &max_jerk);
+
+        /// Sets the state to rest at #position
+        bool reset(const Eigen::Ref<const Eigen::VectorXd> &position);
+
+        /// Sets the state, e.g. to the measured state of the robot. Returns false
+        /// if a vector is not of size get_dim().
+        bool reset(const Eigen::Ref<const Eigen::VectorXd> &position,
+                   const Eigen::Ref<const Eigen::VectorXd> &velocity,
+                   const Eigen::Ref<const Eigen::VectorXd> &acceleration);
+
+        /// Advances the state one sample period toward a stationary #target
+        bool update(const Eigen::Ref<const Eigen::VectorXd> &target);
+
+        /// Advances the state one sample period toward #target moving at
+        /// #target_velocity, which removes the lag when following a moving target
+        bool update(const Eigen::Ref<const Eigen::VectorXd> &target,
+                    const Eigen::Ref<const Eigen::VectorXd> &target_velocity);
+
+        /// Returns the current position
+        const Eigen::VectorXd &position() const;
+
+        /// Returns the current velocity
+        const Eigen::VectorXd &velocity() const;
+
+        /// Returns the current acceleration
+        const Eigen::VectorXd &acceleration() const;
+
+        /// Returns the sample period
+        const mahi::util::Time &get_sample_period() const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+    private:
+        mahi::util::Time Ts_; // sample period
+        double dt_;           // sample period in seconds
+
+        std::size_t path_dim_; // dimensionality of the state
+
+        Eigen::VectorXd max_velocity_;     // velocity limits
+        Eigen::VectorXd max_acceleration_; // acceleration limits
+        Eigen::VectorXd max_jerk_;         // jerk limits
+
+        Eigen::VectorXd position_;     // current position
+        Eigen::VectorXd velocity_;     // current velocity
+        Eigen::VectorXd acceleration_; // current acceleration
+    };
+
+}  // namespace robo
+}  // namespace mahi
@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <functional>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Non-owning wrapper that plays a Trajectory through a time map s(t) from
+    /// playback time t to trajectory time s, applied lazily in at_time(). The
+    /// derivatives follow the chain rule, q' = dq/ds * s' and
+    /// q'' = d2q/ds2 * s'^2 + dq/ds * s'', so a speed change costs nothing up
+    /// front and can be made every tick. The trajectory must outlive the wrapper.
+    class RetimedTrajectory {
+
+    public:
+        /// Monotone time map: given playback time #t, writes trajectory time #s and
+        /// its first and second derivatives with respect to t
+        typedef std::function<void(const mahi::util::Time &t, mahi::util::Time &s,
+                                   double &s_dot, double &s_ddot)> TimeMap;
+
+    public:
+        /// Constructor. Plays #trajectory at its own timing until the speed or
+        /// time map is changed.
+        explicit RetimedTrajectory(const Trajectory &trajectory);
+        explicit RetimedTrajectory(Trajectory &&trajectory) = delete;
+
+        /// Plays the trajectory at #speed times its own rate from #now on, replacing
+        /// any general time map. The map is re-anchored at #now so the position
+        /// stays continuous. Returns false if #speed is negative.
+        bool set_speed(double speed, const mahi::util::Time &now);
+
+        /// Returns the current speed factor of the linear time map
+        double get_speed() const;
+
+        /// Replaces the linear speed map with a general monotone #time_map
+        void set_time_map(const TimeMap &time_map);
+
+        /// Restores the linear speed map, anchored so that the trajectory is played
+        /// at its own timing
+        void clear_time_map();
+
+        /// Returns the trajectory time that playback time #instant maps to
+        mahi::util::Time trajectory_time(const mahi::util::Time &instant) const;
+
+        /// Returns the position at playback time #instant
+        std::vector<double> at_time(const mahi::util::Time &instant,
+                                    Trajectory::Interp interp_method = Trajectory::Interp::Linear) const;
+
+        /// Allocation-free at_time() with a playback cursor; see Trajectory::at_time()
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position,
+                     Trajectory::Interp interp_method = Trajectory::Interp::Linear) const;
+
+        /// Writes the position, velocity and acceleration at playback time #instant,
+        /// with the derivatives taken with respect to playback time
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position,
+                     Eigen::Ref<Eigen::VectorXd> velocity,
+                     Eigen::Ref<Eigen::VectorXd> acceleration,
+                     Trajectory::Interp interp_method = Trajectory::Interp::Linear) const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+    private:
+        /// Evaluates the time map at #instant
+        void map_time(const mahi::util::Time &instant, mahi::util::Time &s, double &s_dot,
+                      double &s_ddot) const;
+
+    private:
+        const Trajectory *trajectory_; // trajectory being played
+
+        double speed_; // slope of the linear time map
+
+        mahi::util::Time anchor_t_; // playback time of the linear map's anchor
+
+        mahi::util::Time anchor_s_; // trajectory time of the linear map's anchor
+
+        TimeMap time_map_; // general time map, used instead of the linear map when set
+    };
+
+}  // namespace robo
+}  // namespace mahi
@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/WayPoint.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Trajectory fed online by one producer thread (e.g. a planner) and played
+    /// back by one consumer thread (e.g. a control loop). Waypoints live in a
+    /// fixed-capacity lock-free ring allocated at construction; neither side
+    /// blocks, and the consumer never allocates. Segments the consumer has played
+    /// past are reclaimed automatically.
+    class StreamingTrajectory {
+
+    public:
+        /// Constructor. #capacity is the number of waypoints the ring can hold.
+        StreamingTrajectory(std::size_t path_dim, std::size_t capacity);
+
+        /// Producer: appends a waypoint. Returns false without blocking if the ring
+        /// is full, the dimension is wrong, or the time is before the last waypoint.
+        bool push(const WayPoint &waypoint);
+
+        /// Producer: appends a waypoint given as a time and position
+        bool push(const mahi::util::Time &time, const Eigen::Ref<const Eigen::VectorXd> &position);
+
+        /// Consumer: writes the linearly interpolated position at #instant into
+        /// #position and releases waypoints older than the current segment. Holds
+        /// the first or last available waypoint outside of the buffered time range.
+        /// Returns false if no waypoints are buffered.
+        bool at_time(const mahi::util::Time &instant, Eigen::Ref<Eigen::VectorXd> position);
+
+        /// Returns the number of buffered waypoints
+        std::size_t size() const;
+
+        /// Returns the maximum number of buffered waypoints
+        std::size_t capacity() const;
+
+        /// Returns whether or not no waypoints are buffered
+        bool empty() const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+    private:
+        StreamingTrajectory(const StreamingTrajectory &) = delete;
+        StreamingTrajectory &operator=(const StreamingTrajectory &) = delete;
+
+        /// Producer: writes slot #index and publishes it
+        bool commit(std::size_t index, const mahi::util::Time &time, const double *position);
+
+    private:
+        const std::size_t path_dim_;  // dimensionality of the path
+        const std::size_t capacity_;  // number of slots in the ring
+
+        std::vector<std::int64_t> times_;  // slot times [us]
+        std::vector<double> positions_;    // slot positions, capacity_ x path_dim_ row-major
+
+        alignas(64) std::atomic<std::size_t> head_;  // count of waypoints pushed, written by producer
+        alignas(64) std::atomic<std::size_t> tail_;  // count of waypoints released, written by consumer
+
+        std::int64_t last_time_;  // time of the last waypoint pushed, producer only
+    };
+
+}  // namespace robo
+}  // namespace mahi
@@ -20,6 +20,8 @@
 #include <Mahi/Robo/Trajectories/WayPoint.hpp>
 #include <Mahi/Util/Math/Constants.hpp>
 #include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <iterator>
 #include <vector>
 
 namespace mahi {
@@ -32,7 +34,73 @@ namespace robo {
     class Trajectory {
 
     public:
-        enum Interp { Linear };
+        enum Interp {
+            Linear,       ///< piecewise linear between waypoints
+            CubicNatural, ///< C2 cubic spline with zero acceleration at the ends
+            CubicClamped  ///< C2 cubic spline with zero velocity at the ends
+        };
+
+        /// Row-major matrix of positions, one row per waypoint
+        typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> PositionMatrix;
+
+        /// Lazy sequence of the points linspace_points() would return. Each point
+        /// is computed when its iterator is dereferenced, so iterating stores
+        /// nothing and allocates nothing for paths of up to WayPoint::INLINE_DIM
+        /// dimensions.
+        class LinspaceRange {
+
+        public:
+            class const_iterator {
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef WayPoint value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const WayPoint *pointer;
+                typedef WayPoint reference;
+
+                const_iterator() : range_(nullptr), index_(0) {}
+                const_iterator(const LinspaceRange *range, std::size_t index) : range_(range), index_(index) {}
+
+                WayPoint operator*() const { return (*range_)[index_]; }
+                const_iterator &operator++() { ++index_; return *this; }
+                const_iterator operator++(int) { const_iterator it(*this); ++index_; return it; }
+                bool operator==(const const_iterator &other) const { return index_ == other.index_; }
+                bool operator!=(const const_iterator &other) const { return index_ != other.index_; }
+
+            private:
+                const LinspaceRange *range_; // range being iterated
+                std::size_t index_;          // index of the current point in the range
+            };
+
+        public:
+            /// Constructor; see linspace_range()
+            LinspaceRange(const WayPoint &initial, const WayPoint &final, std::size_t n,
+                          bool include_initial, bool include_final);
+
+            /// Returns the point at #index
+            WayPoint operator[](std::size_t index) const;
+
+            const_iterator begin() const { return const_iterator(this, 0); }
+            const_iterator end() const { return const_iterator(this, size_); }
+
+            /// Returns the number of points in the range
+            std::size_t size() const { return size_; }
+
+            /// Writes the times and positions of all points into #times, resized to
+            /// size(), and #positions, which must be size() x get_dim()
+            bool write(std::vector<mahi::util::Time> &times, Eigen::Ref<PositionMatrix> positions) const;
+
+        private:
+            /// Returns the time of the point at #index
+            mahi::util::Time time(std::size_t index) const;
+
+        private:
+            WayPoint initial_;   // first point of the full spacing
+            WayPoint final_;     // last point of the full spacing
+            std::size_t size_;   // number of points in the range
+            std::size_t offset_; // index in the full spacing of the first point in the range
+            std::size_t count_;  // number of points in the full spacing
+        };
 
     public:
         /// Returns vector of n time-linearly-interpolated points with equal spacing
@@ -43,6 +111,22 @@ namespace robo {
             bool include_initial = true,
             bool include_final = true);
 
+        /// Same points as linspace_points(), as a range that computes each point on
+        /// access instead of building a vector. An invalid pair of points gives a
+        /// range holding just #initial, as linspace_points() does.
+        static LinspaceRange linspace_range(const WayPoint &initial,
+            const WayPoint &final, std::size_t n,
+            bool include_initial = true,
+            bool include_final = true);
+
+        /// Same points as linspace_points(), written straight into #times, resized
+        /// to n, and #positions, which must be n x get_dim() of the points
+        static bool linspace_points(const WayPoint &initial, const WayPoint &final,
+            std::size_t n, std::vector<mahi::util::Time> &times,
+            Eigen::Ref<PositionMatrix> positions,
+            bool include_initial = true,
+            bool include_final = true);
+
         /// Linearly interpolates between the two points based on the given time.
         /// Saturates to initial and final values if time is outside of range.
         static WayPoint linear_time_interpolate(const WayPoint &initial, const WayPoint &final,
@@ -53,35 +137,164 @@ namespace robo {
         Trajectory(std::size_t path_dim, const std::vector<WayPoint> &waypoints,
             Interp interp_method = Interp::Linear,
             const std::vector<double> &max_diff = { mahi::util::INF });
+        Trajectory(const std::vector<mahi::util::Time> &times,
+            const Eigen::Ref<const PositionMatrix> &positions,
+            Interp interp_method = Interp::Linear,
+            const std::vector<double> &max_diff = { mahi::util::INF });
 
         /// Returns a position along the trajectory at the specific instant in time
-        /// using one of the available interpolation methods
+        /// using one of the available interpolation methods. Queries never modify
+        /// the trajectory: the cubic methods use the coefficients solved by
+        /// set_waypoints(), set_interp_method() or prepare(), and fail with a
+        /// warning if none are current for the requested method; see is_prepared().
         std::vector<double>
             at_time(const mahi::util::Time &instant, Interp interp_method = Interp::Linear) const;
 
-        /// Index-based read access to waypoints
-        const WayPoint &operator[](std::size_t index) const;
+        /// Same as at_time(), but the segment search starts at #cursor, which is
+        /// updated to the segment found. Reusing one cursor for a sequence of
+        /// increasing instants (e.g. playback in a control loop) makes each lookup
+        /// amortized O(1) regardless of the trajectory length.
+        std::vector<double> at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                                    Interp interp_method = Interp::Linear) const;
+
+        /// Writes the position at #instant into the caller-provided #position, which
+        /// must already be of size get_dim(). Performs no heap allocation, so it is
+        /// safe to call from a real-time loop. Returns false if nothing was written.
+        bool at_time(const mahi::util::Time &instant, Eigen::Ref<Eigen::VectorXd> position,
+                     Interp interp_method = Interp::Linear) const;
+
+        /// Allocation-free at_time() with a playback cursor
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position,
+                     Interp interp_method = Interp::Linear) const;
+
+        /// Writes the position, velocity and acceleration at #instant from a single
+        /// segment lookup. Derivatives are analytic for the interpolation method
+        /// used: piecewise constant velocity for Linear, C2 for the cubic methods.
+        /// Outside the time range the trajectory holds its end points at rest.
+        bool at_time(const mahi::util::Time &instant, Eigen::Ref<Eigen::VectorXd> position,
+                     Eigen::Ref<Eigen::VectorXd> velocity,
+                     Eigen::Ref<Eigen::VectorXd> acceleration,
+                     Interp interp_method = Interp::Linear) const;
+
+        /// Position, velocity and acceleration at_time() with a playback cursor
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position,
+                     Eigen::Ref<Eigen::VectorXd> velocity,
+                     Eigen::Ref<Eigen::VectorXd> acceleration,
+                     Interp interp_method = Interp::Linear) const;
+
+        /// Samples the trajectory at each of #instants into the corresponding row of
+        /// #positions, which must be instants.size() x get_dim(). Sorted instants are
+        /// handled in one merged sweep over the waypoints, O(size() + instants.size()).
+        bool sample_many(const std::vector<mahi::util::Time> &instants,
+                         Eigen::Ref<PositionMatrix> positions,
+                         Interp interp_method = Interp::Linear) const;
+
+        /// Returns the trajectory sampled at each of #instants, one row per instant
+        PositionMatrix sample_many(const std::vector<mahi::util::Time> &instants,
+                                   Interp interp_method = Interp::Linear) const;
+
+        /// Returns a new trajectory sampled every #sample_period from the first
+        /// waypoint time up to the last
+        Trajectory resample(const mahi::util::Time &sample_period,
+                            Interp interp_method = Interp::Linear) const;
+
+        /// Returns a copy with as many waypoints removed as possible while playback
+        /// under #interp_method stays within #tolerance of every original waypoint
+        /// (one value per dimension, or a single value for all). Linear uses
+        /// Douglas-Peucker, and since both trajectories are then piecewise linear
+        /// the bound holds at every instant. The cubic methods re-insert the worst
+        /// dropped waypoint of each span until the spline through the kept ones is
+        /// within tolerance at every original waypoint; between them the bound is
+        /// not guaranteed, as the two splines may differ slightly more there.
+        /// #num_threads > 1 runs the Linear pass of long trajectories in parallel,
+        /// with the same result as one thread; 0 uses all hardware threads.
+        Trajectory compress(const std::vector<double> &tolerance,
+                            Interp interp_method = Interp::Linear,
+                            std::size_t num_threads = 1) const;
+
+        /// Returns this path retimed to the minimum duration that keeps every
+        /// dimension within #max_velocity and #max_acceleration (one value per
+        /// dimension, or a single value for all), starting and ending at rest at
+        /// the time of the first waypoint. The velocity bound is also capped by
+        /// max_diff, so the result still passes validate(). The waypoints are
+        /// treated as samples of a smooth path: derivatives along the path come
+        /// from finite differences, and a forward/backward pass over the squared
+        /// path speed finds the fastest feasible schedule (TOPP).
+        Trajectory time_optimal(const std::vector<double> &max_velocity,
+                                const std::vector<double> &max_acceleration) const;
+
+        /// Returns a read-only view of the position of the waypoint at #index in
+        /// the underlying storage, without copying. Its time is times()[index].
+        Eigen::Map<const Eigen::RowVectorXd> position(std::size_t index) const;
+
+        /// Returns a copy of the waypoint at #index, assembled from the underlying
+        /// storage since waypoints are not stored as WayPoint objects
+        WayPoint waypoint(std::size_t index) const;
+
+        /// Same as waypoint(). The copy is const so that writes through it, which
+        /// could never reach the trajectory, do not compile; use add_waypoint().
+        const WayPoint operator[](std::size_t index) const;
 
 		/// Index-based write access to waypoints
 		bool add_waypoint(std::size_t index, const WayPoint &waypoint);
 
-		/// Return the first waypoint
-		const WayPoint &front() const; 
+		/// Return a copy of the first waypoint; see operator[]
+		const WayPoint front() const;
+
+		/// Return a copy of the last waypoint; see operator[]
+		const WayPoint back() const;
 
-		/// Return the last waypoint
-		const WayPoint &back() const;
+		/// Returns the times of all waypoints as one contiguous array
+		const std::vector<mahi::util::Time> &times() const;
+
+		/// Returns the positions of all waypoints as a size() x get_dim() row-major
+		/// map over the underlying contiguous storage
+		Eigen::Map<const PositionMatrix> positions() const;
 
         /// Sets the waypoints that make the trajectory
         bool set_waypoints(std::size_t path_dim, const std::vector<WayPoint> &waypoints,
             Interp interp_method = Interp::Linear,
             const std::vector<double> &max_diff = { mahi::util::INF });
 
-        /// Sets the method of interpolation to be used
+        /// Sets the waypoints from a time array and a matching row-major position
+        /// matrix, avoiding the construction of intermediate WayPoint objects
+        bool set_waypoints(const std::vector<mahi::util::Time> &times,
+            const Eigen::Ref<const PositionMatrix> &positions,
+            Interp interp_method = Interp::Linear,
+            const std::vector<double> &max_diff = { mahi::util::INF });
+
+        /// Sets the method of interpolation to be used. For the cubic methods, the
+        /// spline coefficients are solved here and whenever the waypoints are set;
+        /// after add_waypoint(), push_back() or resize(), call prepare() before
+        /// the next cubic query.
         void set_interp_method(Interp interp_method);
 
+        /// Solves the spline coefficients of a cubic #interp_method for the current
+        /// waypoints, so that const queries with that method neither allocate nor
+        /// write. Does nothing for Linear or if they are already current.
+        void prepare(Interp interp_method);
+
+        /// prepare() for the trajectory's own interpolation method
+        void prepare();
+
+        /// Returns whether or not queries with #interp_method can be answered, i.e.
+        /// it is Linear or the spline for it is current
+        bool is_prepared(Interp interp_method) const;
+
         /// Sets the maximum allowable time derivative on the trajectory
         void set_max_diff(const std::vector<double> &max_diff);
 
+        /// Declares that the waypoints are spaced uniformly by #sample_period starting
+        /// at the first waypoint, so at_time() can locate segments with index
+        /// arithmetic instead of searching. Uniform spacing is also detected
+        /// automatically by the constructor, set_waypoints() and push_back().
+        void set_sample_period(const mahi::util::Time &sample_period);
+
+        /// Returns whether or not the waypoints are known to be uniformly spaced in time
+        bool is_uniform() const;
+
         /// Returns whether or not the trajectory is empty, having no points
         bool empty() const;
 
@@ -100,13 +313,59 @@ namespace robo {
         /// Adds a single waypoint to the end of the list
         bool push_back(const WayPoint &waypoint);
 
-		/// Validate that the trajectory has correct dimensions, smoothness, and time properties
+		/// Validate that the trajectory has correct dimensions, smoothness, and time properties.
+		/// Each segment is checked as its waypoints are set, so this is O(1) for a
+		/// valid trajectory; the full scan only runs to report a failure.
 		bool validate() const;
 
 		/// Overload the << stream operator with a Trajectory as the rhs argument
 		friend std::ostream& operator<<(std::ostream& os, const Trajectory& trajectory);
 
     private:
+        /// Evaluates the trajectory at #instant into #position, and optionally its
+        /// derivatives, each of which must hold get_dim() values. Assumes the
+        /// trajectory is not empty.
+        bool evaluate(const mahi::util::Time &instant, std::size_t &cursor,
+                      Interp interp_method, double *position,
+                      double *velocity = nullptr, double *acceleration = nullptr) const;
+
+        /// Returns a pointer to the positions of the waypoint at #index
+        const double *row(std::size_t index) const;
+        double *row(std::size_t index);
+
+        /// Linearly interpolates between waypoints #before and #after into #position
+        /// and, if given, #velocity and #acceleration
+        void linear_interpolate(std::size_t before, std::size_t after,
+                                const mahi::util::Time &instant, double *position,
+                                double *velocity, double *acceleration) const;
+
+        /// Evaluates the cubic segment starting at waypoint #before into #position
+        /// and, if given, #velocity and #acceleration
+        void cubic_interpolate(std::size_t before, const mahi::util::Time &instant,
+                               double *position, double *velocity,
+                               double *acceleration) const;
+
+        /// Solves the tridiagonal system for the spline second derivatives and
+        /// stores the per-segment polynomial coefficients in coeffs_
+        void compute_spline(Interp interp_method);
+
+        /// Returns the index of the first waypoint with time not before #instant,
+        /// galloping outward from #hint and finishing with a binary search
+        std::size_t find_after(const mahi::util::Time &instant, std::size_t hint) const;
+
+        /// Checks whether times_ is uniformly spaced and updates uniform_ and sample_period_
+        void detect_uniform();
+
+        /// Returns whether the segment from waypoint #index to #index + 1 has
+        /// non-decreasing times and satisfies max_diff
+        bool is_segment_valid(std::size_t index) const;
+
+        /// Re-checks a single segment and updates the running validity state
+        void update_segment(std::size_t index);
+
+        /// Re-checks every segment, e.g. after the waypoints or max_diff change
+        void check_segments();
+
         bool check_max_diff() const;
 
         bool check_waypoints() const;
@@ -125,13 +384,29 @@ namespace robo {
                                // automatically added between waypoints using linear
                                // interpolation at the requested resolution
 
-        std::vector<WayPoint> waypoints_; // vector of underlying waypoints
-
         std::vector<mahi::util::Time>
             times_; // vector of the times associated with the underlying waypoints
 
+        std::vector<double> positions_; // positions of the underlying waypoints, stored
+                                        // contiguously as a size() x path_dim_ row-major block
+
         std::vector<double> max_diff_;
 
+        bool uniform_; // whether or not times_ is uniformly spaced by sample_period_
+
+        double sample_period_; // spacing of times_ in seconds when uniform_ is true
+
+        std::vector<double> coeffs_; // cubic coefficients, 4 per segment and dimension,
+                                     // in ascending powers of the time since the segment start
+
+        bool coeffs_valid_; // whether or not coeffs_ matches the current waypoints
+
+        Interp coeffs_interp_; // cubic method coeffs_ was solved for
+
+        std::vector<char> segment_valid_; // per-segment result of is_segment_valid()
+
+        std::size_t invalid_segments_; // number of zeros in segment_valid_
+
     };
 
 }  // namespace robo
@@ -0,0 +1,176 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Robo/Trajectories/WayPoint.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // FILE FORMAT
+    //==============================================================================
+    //
+    // Binary trajectory files (.traj) are laid out so they can be memory-mapped
+    // and queried in place:
+    //
+    //   [header]     64 bytes, see TrajectoryFileHeader
+    //   [positions]  count x path_dim doubles, row-major
+    //   [times]      count int64 microseconds, non-decreasing
+    //
+    // All values are stored in the byte order of the machine that wrote them;
+    // the endian field lets readers reject files from a machine of the other order.
+
+    struct TrajectoryFileHeader {
+        char          magic[8];         ///< "MAHITRAJ"
+        std::uint32_t version;          ///< file format version
+        std::uint32_t endian;           ///< 0x01020304 as written by the producer
+        std::uint64_t path_dim;         ///< number of dimensions of each waypoint
+        std::uint64_t count;            ///< number of waypoints
+        std::uint64_t positions_offset; ///< byte offset of the position matrix
+        std::uint64_t times_offset;     ///< byte offset of the time column
+        std::uint64_t reserved[2];      ///< zero
+    };
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Streams waypoints to a binary trajectory file chunk by chunk, so
+    /// trajectories larger than memory can be written
+    class TrajectoryWriter {
+
+    public:
+        /// Constructor
+        TrajectoryWriter();
+        TrajectoryWriter(const std::string &filepath, std::size_t path_dim);
+
+        /// Destructor. Closes the file if still open.
+        ~TrajectoryWriter();
+
+        /// Opens #filepath for writing waypoints of dimension #path_dim
+        bool open(const std::string &filepath, std::size_t path_dim);
+
+        /// Appends a single waypoint
+        bool write(const WayPoint &waypoint);
+
+        /// Appends a chunk of waypoints given as times and matching position rows
+        bool write(const std::vector<mahi::util::Time> &times,
+                   const Eigen::Ref<const Trajectory::PositionMatrix> &positions);
+
+        /// Finalizes the header and closes the file. Returns true if successful.
+        bool close();
+
+        /// Returns whether or not the writer has an open file
+        bool is_open() const;
+
+        /// Returns the number of waypoints written so far
+        std::size_t size() const;
+
+        /// Writes an entire Trajectory to #filepath
+        static bool save(const std::string &filepath, const Trajectory &trajectory);
+
+    private:
+        TrajectoryWriter(const TrajectoryWriter &) = delete;
+        TrajectoryWriter &operator=(const TrajectoryWriter &) = delete;
+
+        /// Checks and appends one time to the time column spool
+        bool write_time(const mahi::util::Time &time);
+
+    private:
+        std::string filepath_;      // path of the file being written
+        std::FILE *file_;           // header and positions are written here
+        std::FILE *times_file_;     // times are spooled here until close()
+        std::size_t path_dim_;      // dimension of the waypoints
+        std::uint64_t count_;       // number of waypoints written
+        std::int64_t last_time_;    // time of the last waypoint written [us]
+    };
+
+    /// Read-only binary trajectory file mapped into memory. Queries read the
+    /// mapped time column and position matrix in place without copying or parsing.
+    class MappedTrajectory {
+
+    public:
+        /// Constructor
+        MappedTrajectory();
+        MappedTrajectory(const std::string &filepath);
+
+        /// Destructor. Unmaps the file.
+        ~MappedTrajectory();
+
+        /// Maps #filepath into memory and checks its header
+        bool open(const std::string &filepath);
+
+        /// Unmaps the file
+        void close();
+
+        /// Returns whether or not a file is mapped
+        bool is_open() const;
+
+        /// Returns whether or not the mapped trajectory has no points
+        bool empty() const;
+
+        /// Returns the number of waypoints
+        std::size_t size() const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+        /// Returns the time of the waypoint at #index
+        mahi::util::Time time(std::size_t index) const;
+
+        /// Returns the mapped size() x get_dim() position matrix
+        Eigen::Map<const Trajectory::PositionMatrix> positions() const;
+
+        /// Returns a linearly interpolated position at #instant, holding the end
+        /// points outside of the time range
+        std::vector<double> at_time(const mahi::util::Time &instant) const;
+
+        /// Allocation-free at_time() with a playback cursor; see Trajectory::at_time()
+        bool at_time(const mahi::util::Time &instant, std::size_t &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position) const;
+
+        /// Copies the mapped waypoints into a Trajectory, e.g. to use the cubic
+        /// interpolation methods
+        Trajectory to_trajectory() const;
+
+    private:
+        MappedTrajectory(const MappedTrajectory &) = delete;
+        MappedTrajectory &operator=(const MappedTrajectory &) = delete;
+
+    private:
+        void *data_;                   // start of the mapping
+        std::size_t length_;           // length of the mapping in bytes
+#ifdef _WIN32
+        void *file_handle_;            // handle of the open file
+        void *mapping_handle_;         // handle of the file mapping
+#else
+        int fd_;                       // descriptor of the open file
+#endif
+        std::size_t path_dim_;         // dimension of the waypoints
+        std::size_t count_;            // number of waypoints
+        const std::int64_t *times_;    // mapped time column [us]
+        const double *positions_;      // mapped position matrix
+    };
+
+}  // namespace robo
+}  // namespace mahi
@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Spatial index over the path of a Trajectory, treated as the polyline through
+    /// its waypoints, for finding the point on the path closest to a query point
+    /// (e.g. the robot position in a path-following or virtual-fixture controller).
+    /// Segments are grouped into a balanced bounding-volume hierarchy over
+    /// contiguous index ranges, so a global query visits O(log n) nodes for a
+    /// typical path. The trajectory must outlive the index, and the index must be
+    /// rebuilt if its waypoints change.
+    class TrajectoryIndex {
+
+    public:
+        /// Closest point on the path
+        struct Projection {
+            Projection() : segment(0), alpha(0.0), distance(0.0) {}
+            std::size_t segment;   // index of the waypoint starting the closest segment
+            double alpha;          // fraction along the segment in [0, 1]
+            double distance;       // Euclidean distance from the query point
+            mahi::util::Time time; // trajectory time of the closest point
+        };
+
+    public:
+        /// Constructor
+        TrajectoryIndex();
+        explicit TrajectoryIndex(const Trajectory &trajectory);
+        explicit TrajectoryIndex(Trajectory &&trajectory) = delete;
+
+        /// Builds the index over the waypoints of #trajectory. Returns false if it
+        /// is empty.
+        bool build(const Trajectory &trajectory);
+        bool build(Trajectory &&trajectory) = delete;
+
+        /// Finds the point on the whole path closest to #point. Returns false if
+        /// the index is empty or #point has the wrong dimension.
+        bool closest_point(const Eigen::Ref<const Eigen::VectorXd> &point,
+                           Projection &projection) const;
+
+        /// Finds the point closest to #point among only the segments within
+        /// #window of #hint, e.g. the segment of the previous tick's result. The
+        /// cost is O(window) regardless of the path length, but a closer part of
+        /// the path outside the window is not found.
+        bool closest_point_local(const Eigen::Ref<const Eigen::VectorXd> &point,
+                                 std::size_t hint, std::size_t window,
+                                 Projection &projection) const;
+
+        /// Returns whether or not the index has been built over a trajectory
+        bool empty() const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+    private:
+        /// Node of the hierarchy covering segments [begin, end)
+        struct Node {
+            std::size_t begin; // first segment
+            std::size_t end;   // one past the last segment
+            std::size_t left;  // index of the left child, or 0 for a leaf
+            std::size_t right; // index of the right child, or 0 for a leaf
+        };
+
+        /// Builds the subtree over segments [begin, end) and returns its node index
+        std::size_t build_node(std::size_t begin, std::size_t end);
+
+        /// Returns the squared distance from #point to the bounding box of #node
+        double box_distance2(std::size_t node, const double *point) const;
+
+        /// Tests segments [begin, end) against #point, updating the best squared
+        /// distance #best and the #projection that achieves it
+        void test_segments(std::size_t begin, std::size_t end, const double *point,
+                           double &best, Projection &projection) const;
+
+        /// Branch-and-bound search of the hierarchy for segments closer than #best
+        void search(const double *point, double &best, Projection &projection) const;
+
+        /// Fills in the distance and time of #projection from the best squared distance
+        void finish(double best, Projection &projection) const;
+
+    private:
+        const Trajectory *trajectory_; // indexed trajectory
+
+        std::size_t path_dim_; // dimensionality of the path
+
+        std::size_t segments_; // number of segments in the path
+
+        std::vector<Node> nodes_; // hierarchy nodes, root first
+
+        std::vector<double> bounds_; // node boxes, lower then upper corner, 2 x path_dim_ per node
+    };
+
+}  // namespace robo
+}  // namespace mahi
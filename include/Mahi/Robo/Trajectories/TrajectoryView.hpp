@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Non-owning view of one or more Trajectory objects laid end-to-end in time.
+    /// Slicing, shifting and appending only edit a short list of pieces; at_time()
+    /// delegates to the underlying trajectories, so no waypoints are ever copied.
+    /// The viewed trajectories must outlive the view and any views made from it,
+    /// so temporaries are rejected.
+    class TrajectoryView {
+
+    public:
+        /// Playback position for repeated at_time() calls
+        struct Cursor {
+            Cursor() : piece(0), index(0) {}
+            std::size_t piece; // piece the last query fell in
+            std::size_t index; // waypoint cursor within that piece's trajectory
+        };
+
+    public:
+        /// Constructor
+        TrajectoryView();
+        explicit TrajectoryView(const Trajectory &trajectory);
+        explicit TrajectoryView(Trajectory &&trajectory) = delete;
+
+        /// Returns the part of this view between #from and #to
+        TrajectoryView slice(const mahi::util::Time &from, const mahi::util::Time &to) const;
+
+        /// Returns this view delayed by #offset
+        TrajectoryView shift(const mahi::util::Time &offset) const;
+
+        /// Appends #next so that it starts where this view ends. Returns false if
+        /// the dimensions differ.
+        bool append(const TrajectoryView &next);
+        bool append(const Trajectory &next);
+        bool append(Trajectory &&next) = delete;
+
+        /// Returns the position at #instant, holding the end points outside of the
+        /// view. The pieces are interpolated with #interp_method.
+        std::vector<double> at_time(const mahi::util::Time &instant,
+                                    Trajectory::Interp interp_method = Trajectory::Interp::Linear) const;
+
+        /// Allocation-free at_time() with a playback cursor; see Trajectory::at_time()
+        bool at_time(const mahi::util::Time &instant, Cursor &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position,
+                     Trajectory::Interp interp_method = Trajectory::Interp::Linear) const;
+
+        /// Position, velocity and acceleration at_time() with a playback cursor
+        bool at_time(const mahi::util::Time &instant, Cursor &cursor,
+                     Eigen::Ref<Eigen::VectorXd> position,
+                     Eigen::Ref<Eigen::VectorXd> velocity,
+                     Eigen::Ref<Eigen::VectorXd> acceleration,
+                     Trajectory::Interp interp_method = Trajectory::Interp::Linear) const;
+
+        /// Returns the time the view starts
+        mahi::util::Time start_time() const;
+
+        /// Returns the time the view ends
+        mahi::util::Time end_time() const;
+
+        /// Returns whether or not the view covers no trajectory
+        bool empty() const;
+
+        /// Returns the number of trajectory pieces in the view
+        std::size_t pieces() const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+    private:
+        /// Window of one trajectory placed on the view's time axis
+        struct Piece {
+            const Trajectory *trajectory; // viewed trajectory
+            mahi::util::Time start;       // start of the window on the view's time axis
+            mahi::util::Time end;         // end of the window on the view's time axis
+            mahi::util::Time offset;      // view time minus trajectory time
+        };
+
+        /// Returns the index of the piece that covers #instant, starting the search at #hint
+        std::size_t find_piece(const mahi::util::Time &instant, std::size_t hint) const;
+
+    private:
+        std::vector<Piece> pieces_; // pieces in time order, each starting where the last ends
+
+        std::size_t path_dim_; // dimensionality of the path
+    };
+
+}  // namespace robo
+}  // namespace mahi
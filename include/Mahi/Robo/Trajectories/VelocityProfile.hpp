@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Robo/Trajectories/WayPoint.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <array>
+#include <vector>
+
+namespace mahi {
+namespace robo {
+
+    //==============================================================================
+    // CLASS DECLARATION
+    //==============================================================================
+
+    /// Time-optimal rest-to-rest point-to-point move with a classic industrial
+    /// velocity profile. All dimensions move along the straight line from start to
+    /// goal and arrive together, so the plan is one profile s(t) from 0 to 1 whose
+    /// limits are the tightest of each dimension's limits divided by its distance.
+    /// The phases are found in closed form when planning, and the move is
+    /// evaluated from them at any time without sampling.
+    class VelocityProfile {
+
+    public:
+        /// Shape of the velocity profile
+        enum Shape {
+            Trapezoidal, ///< bang-coast-bang acceleration, limiting velocity and acceleration
+            SCurve       ///< seven-segment profile that also limits jerk
+        };
+
+    public:
+        /// Constructor
+        VelocityProfile();
+        VelocityProfile(Shape shape, const WayPoint &start, const std::vector<double> &goal,
+                        const std::vector<double> &max_velocity,
+                        const std::vector<double> &max_acceleration,
+                        const std::vector<double> &max_jerk = std::vector<double>());
+
+        /// Plans the fastest move from #start to #goal within the per-dimension
+        /// limits, which must be positive and finite. #max_jerk is only used, and
+        /// only required, for Shape::SCurve. Returns true if successful.
+        bool plan(Shape shape, const WayPoint &start, const std::vector<double> &goal,
+                  const std::vector<double> &max_velocity,
+                  const std::vector<double> &max_acceleration,
+                  const std::vector<double> &max_jerk = std::vector<double>());
+
+        /// Returns the position at #instant, holding the end points outside of the move
+        std::vector<double> at_time(const mahi::util::Time &instant) const;
+
+        /// Writes the position at #instant into #position, which must be of size get_dim()
+        bool at_time(const mahi::util::Time &instant, Eigen::Ref<Eigen::VectorXd> position) const;
+
+        /// Writes the position, velocity and acceleration at #instant, each of which
+        /// must be of size get_dim()
+        bool at_time(const mahi::util::Time &instant, Eigen::Ref<Eigen::VectorXd> position,
+                     Eigen::Ref<Eigen::VectorXd> velocity,
+                     Eigen::Ref<Eigen::VectorXd> acceleration) const;
+
+        /// Returns the move sampled every #sample_period, ending on the goal
+        Trajectory trajectory(const mahi::util::Time &sample_period) const;
+
+        /// Returns the time the move starts
+        mahi::util::Time start_time() const;
+
+        /// Returns the time the move reaches the goal, rounded up to the microsecond
+        mahi::util::Time end_time() const;
+
+        /// Returns the shape of the planned profile
+        Shape get_shape() const;
+
+        /// Returns whether or not a move has been planned
+        bool empty() const;
+
+        /// Returns the path dimension
+        std::size_t get_dim() const;
+
+        /// Clears the move
+        void clear();
+
+    private:
+        /// Stretch of the profile with constant jerk
+        struct Phase {
+            double start; // time since the start of the move
+            double s;     // path parameter at the start of the phase
+            double v;     // its first derivative
+            double a;     // its second derivative
+            double j;     // its third derivative, constant over the phase
+        };
+
+        /// Appends a phase of #duration starting with #acceleration and #jerk
+        void push_phase(double duration, double acceleration, double jerk);
+
+        /// Evaluates the path parameter and its derivatives at #instant
+        void evaluate(const mahi::util::Time &instant, double &s, double &s_dot, double &s_ddot) const;
+
+    private:
+        Shape shape_; // shape of the planned profile
+
+        std::size_t path_dim_; // dimensionality of the path
+
+        mahi::util::Time t0_; // time of the start point
+        double T_;            // duration of the move in seconds
+
+        Eigen::VectorXd q_0_;      // start position
+        Eigen::VectorXd distance_; // goal minus start position
+
+        std::array<Phase, 7> phases_; // phases of s(t), in order
+        std::size_t num_phases_;      // number of phases in use
+    };
+
+}  // namespace robo
+}  // namespace mahi
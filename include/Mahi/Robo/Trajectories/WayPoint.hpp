@@ -19,6 +19,8 @@
 
 #include <Mahi/Util/Math/Constants.hpp>
 #include <Mahi/Util/Timing/Time.hpp>
+#include <Eigen/Dense>
+#include <array>
 #include <vector>
 
 namespace mahi {
@@ -30,14 +32,31 @@ namespace robo {
 
     class WayPoint {
 
+    public:
+        /// Largest dimension stored inline in the WayPoint itself. Waypoints up to
+        /// this dimension are created, copied and modified without heap traffic;
+        /// larger ones fall back to a heap-allocated vector.
+        static const std::size_t INLINE_DIM = 16;
+
     public:
         /// Constructor
         WayPoint();
         WayPoint(const mahi::util::Time &time, const std::vector<double> &position);
+        WayPoint(const mahi::util::Time &time, const double *position, std::size_t path_dim);
 
         const mahi::util::Time &when() const;
 
-        const std::vector<double> &get_pos() const;
+        /// Returns a read-only view of the position, without copying
+        Eigen::Map<const Eigen::VectorXd> position() const;
+
+        /// Returns a copy of the position vector, kept for compatibility. Each call
+        /// allocates the vector on the heap, so prefer position(), data() or
+        /// operator[] wherever that matters.
+        std::vector<double> get_pos() const;
+
+        /// Returns a pointer to the get_dim() contiguous position values
+        const double *data() const;
+        double *data();
 
 		std::vector<double> get_point() const;
 
@@ -58,6 +77,7 @@ namespace robo {
         /// Overwrites the position vector associated with this point, resizing the
         /// vector to match the size of the input
         WayPoint set_pos(const std::vector<double> &pos);
+        WayPoint set_pos(const double *pos, std::size_t path_dim);
 
         /// Returns the path dimension
         std::size_t get_dim() const;
@@ -70,7 +90,9 @@ namespace robo {
     private:
         mahi::util::Time time_; // time of the waypoint
 
-        std::vector<double> pos_; // vector of positions of the waypoint.
+        std::array<double, INLINE_DIM> inline_pos_; // positions of the waypoint when path_dim_ <= INLINE_DIM
+
+        std::vector<double> heap_pos_; // positions of the waypoint when path_dim_ > INLINE_DIM
 
         std::size_t path_dim_; // number of dimensions of the waypoint.
     };
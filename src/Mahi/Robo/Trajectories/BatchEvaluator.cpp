@@ -0,0 +1,163 @@
+#include <Mahi/Robo/Trajectories/BatchEvaluator.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <algorithm>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    namespace {
+        // fewest rows in a task, so queue traffic stays small next to the sampling
+        const std::size_t MIN_TASK_ROWS = 256;
+
+        // tasks dealt per thread, giving idle threads something to steal
+        const std::size_t TASKS_PER_THREAD = 8;
+    }
+
+    BatchEvaluator::BatchEvaluator(std::size_t num_threads) :
+        num_threads_(num_threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : num_threads),
+        queues_(new Queue[num_threads_]),
+        batch_(0),
+        running_(0),
+        stop_(false),
+        trajectories_(nullptr),
+        instants_(nullptr),
+        outputs_(nullptr),
+        interp_method_(Trajectory::Interp::Linear)
+    {
+        threads_.reserve(num_threads_ - 1);
+        for (std::size_t i = 1; i < num_threads_; ++i) {
+            threads_.push_back(std::thread(&BatchEvaluator::worker, this, i));
+        }
+    }
+
+    BatchEvaluator::~BatchEvaluator() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (std::size_t i = 0; i < threads_.size(); ++i) {
+            threads_[i].join();
+        }
+    }
+
+    bool BatchEvaluator::sample_many(const std::vector<const Trajectory *> &trajectories, const std::vector<Time> &instants, std::vector<Trajectory::PositionMatrix> &outputs, Trajectory::Interp interp_method) {
+        if (outputs.size() != trajectories.size()) {
+            LOG(Warning) << "Outputs given to BatchEvaluator::sample_many() must match the number of trajectories. Output not written.";
+            return false;
+        }
+        for (std::size_t i = 0; i < trajectories.size(); ++i) {
+            if (trajectories[i] == nullptr || trajectories[i]->empty()) {
+                LOG(Warning) << "Attempted to sample an empty trajectory in BatchEvaluator::sample_many(). Output not written.";
+                return false;
+            }
+            if (static_cast<std::size_t>(outputs[i].rows()) != instants.size() || static_cast<std::size_t>(outputs[i].cols()) != trajectories[i]->get_dim()) {
+                LOG(Warning) << "Outputs given to BatchEvaluator::sample_many() must be of size instants.size() x path_dim. Output not written.";
+                return false;
+            }
+            if (!trajectories[i]->is_prepared(interp_method)) {
+                LOG(Warning) << "Attempted to sample a trajectory whose spline is not prepared in BatchEvaluator::sample_many(). Call Trajectory::prepare() first. Output not written.";
+                return false;
+            }
+        }
+        if (instants.empty()) {
+            return true;
+        }
+        // deal out chunks of rows round-robin
+        const std::size_t total = trajectories.size() * instants.size();
+        const std::size_t rows = std::max(MIN_TASK_ROWS, total / (num_threads_ * TASKS_PER_THREAD) + 1);
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < trajectories.size(); ++i) {
+            for (std::size_t begin = 0; begin < instants.size(); begin += rows) {
+                Task task = { i, begin, std::min(begin + rows, instants.size()) };
+                queues_[next].tasks.push_back(task);
+                next = (next + 1) % num_threads_;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            trajectories_ = &trajectories;
+            instants_ = &instants;
+            outputs_ = &outputs;
+            interp_method_ = interp_method;
+            running_ = threads_.size();
+            ++batch_;
+        }
+        start_cv_.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return running_ == 0; });
+        return true;
+    }
+
+    bool BatchEvaluator::sample_many(const std::vector<Trajectory> &trajectories, const std::vector<Time> &instants, std::vector<Trajectory::PositionMatrix> &outputs, Trajectory::Interp interp_method) {
+        std::vector<const Trajectory *> pointers(trajectories.size());
+        for (std::size_t i = 0; i < trajectories.size(); ++i) {
+            pointers[i] = &trajectories[i];
+        }
+        return sample_many(pointers, instants, outputs, interp_method);
+    }
+
+    std::size_t BatchEvaluator::num_threads() const {
+        return num_threads_;
+    }
+
+    void BatchEvaluator::worker(std::size_t index) {
+        std::size_t batch = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [this, batch] { return stop_ || batch_ != batch; });
+                if (stop_) {
+                    return;
+                }
+                batch = batch_;
+            }
+            work(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --running_;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    void BatchEvaluator::work(std::size_t index) {
+        Task task;
+        while (next_task(index, task)) {
+            const Trajectory &trajectory = *(*trajectories_)[task.trajectory];
+            Trajectory::PositionMatrix &output = (*outputs_)[task.trajectory];
+            std::size_t cursor = 0;
+            for (std::size_t k = task.begin; k < task.end; ++k) {
+                Eigen::Map<Eigen::VectorXd> row(output.row(k).data(), output.cols());
+                trajectory.at_time((*instants_)[k], cursor, row, interp_method_);
+            }
+        }
+    }
+
+    bool BatchEvaluator::next_task(std::size_t index, Task &task) {
+        for (std::size_t i = 0; i < num_threads_; ++i) {
+            Queue &queue = queues_[(index + i) % num_threads_];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            // own queue from the front, others from the back
+            if (i == 0) {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            else {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+}  // namespace robo
+}  // namespace mahi
@@ -22,9 +22,9 @@ namespace robo {
 		K_ = Eigen::MatrixXd::Zero(path_dim_,path_dim_);
 		D_ = Eigen::MatrixXd::Zero(path_dim_,path_dim_);
 
-		q_0_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.get_pos().data(), q_0_.get_pos().size());
-		g_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(g_.get_pos().data(), g_.get_pos().size());
-		q_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.get_pos().data(), q_0_.get_pos().size());
+		q_0_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.data(), q_0_.get_dim());
+		g_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(g_.data(), g_.get_dim());
+		q_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.data(), q_0_.get_dim());
 
 		if (!check_param_dim()) {
 			LOG(Warning) << "Path dimensions of input parameters to DynamicMotionPrimitive are inconsistent. Parameters not set.";
@@ -91,7 +91,7 @@ namespace robo {
 			return false;
 		}
 		q_0_ = start;
-		q_0_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.get_pos().data(), q_0_.get_pos().size());
+		q_0_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.data(), q_0_.get_dim());
 		set_timing_parameters();
 		generate_trajectory();
 		return true;
@@ -107,7 +107,7 @@ namespace robo {
 			return false;
 		}
 		g_ = goal;
-		g_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(g_.get_pos().data(), g_.get_pos().size());
+		g_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(g_.data(), g_.get_dim());
 		set_timing_parameters();
 		generate_trajectory();
 		return true;
@@ -123,9 +123,9 @@ namespace robo {
 			return false;
 		}
 		q_0_ = start;
-		q_0_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.get_pos().data(), q_0_.get_pos().size());
+		q_0_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.data(), q_0_.get_dim());
 		g_ = goal;
-		g_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(g_.get_pos().data(), g_.get_pos().size());
+		g_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(g_.data(), g_.get_dim());
 		set_timing_parameters();
 		generate_trajectory();
 		return true;
@@ -183,7 +183,7 @@ namespace robo {
 		}
 
 		// initial conditions
-		q_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.get_pos().data(), q_0_.get_pos().size());
+		q_mat_ = Eigen::Map<const Eigen::VectorXd, Eigen::Unaligned>(q_0_.data(), q_0_.get_dim());
 		q_dot_mat_ = Eigen::VectorXd::Zero(path_dim_);
 		q_ddot_mat_ = Eigen::VectorXd::Zero(path_dim_);
 		for (std::size_t i = 0; i < path_dim_; ++i) {
@@ -201,11 +201,13 @@ namespace robo {
 			for (std::size_t j = 0; j < path_dim_; ++j) {
 				q_dot_mat_(j) = integrator_[j + path_dim_].update(q_ddot_mat_(j), seconds(times_[current_time_idx_]));
 			}
-			std::vector<double> vec(q_mat_.data(), q_mat_.data() + q_mat_.rows() * q_mat_.cols());
-			trajectory_.add_waypoint(current_time_idx_, WayPoint(seconds(times_[current_time_idx_]), vec));
+			trajectory_.add_waypoint(current_time_idx_, WayPoint(seconds(times_[current_time_idx_]), q_mat_.data(), q_mat_.size()));
 			current_time_idx_++;
 		}
 
+		trajectory_.set_sample_period(Ts_);
+		trajectory_.prepare();
+
 		if (!trajectory_.validate()) {
 			LOG(Error) << "Trajectory generated by DMP was invalid.";
 			return;
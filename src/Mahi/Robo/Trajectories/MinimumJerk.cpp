@@ -1,6 +1,8 @@
 #include <Mahi/Robo/Trajectories/MinimumJerk.hpp>
 #include <Mahi/Util/Logging/Log.hpp>
 #include <Mahi/Util/Math/Functions.hpp>
+#include <algorithm>
+#include <cmath>
 
 using namespace mahi::util;
 
@@ -11,8 +13,12 @@ namespace robo {
 		Ts_(sample_period),
 		q_0_(start),
 		g_(goal),
-		T_(g_.when().as_seconds()-q_0_.when().as_seconds()),
-		path_dim_(start.get_dim())
+		v_0_(start.get_dim(), 0.0),
+		a_0_(start.get_dim(), 0.0),
+		path_dim_(start.get_dim()),
+		sampled_(false),
+		interp_method_(Trajectory::Interp::Linear),
+		max_diff_({ INF })
 	{
 		if (!check_param_dim()) {
 			LOG(Warning) << "Path dimensions of input parameters to MinimumJerk are inconsistent. Parameters not set.";
@@ -26,28 +32,104 @@ namespace robo {
 			return;
 		}
 
+		if (Ts_ <= Time::Zero) {
+			LOG(Warning) << "Sample period given to MinimumJerk must be positive. Parameters not set.";
+			clear();
+			return;
+		}
+
 		set_timing_parameters();
 
 		generate_trajectory();
 	}
 
 	const Trajectory& MinimumJerk::trajectory() {
+		if (sampled_) {
+			return trajectory_;
+		}
+		sampled_ = true;
+		if (coeffs_.empty()) {
+			trajectory_.clear();
+			return trajectory_;
+		}
+
+		// after replan() the duration need not be a multiple of Ts_, in which case
+		// the last sample is the goal
+		std::vector<Time> times(path_size_);
+		Trajectory::PositionMatrix positions(path_size_, path_dim_);
+		for (std::size_t i = 0; i < path_size_; ++i) {
+			times[i] = std::min(q_0_.when() + microseconds(static_cast<int64>(i) * Ts_.as_microseconds()), g_.when());
+			evaluate(times[i], positions.row(i).data(), nullptr, nullptr, nullptr);
+		}
+		trajectory_.set_waypoints(times, positions, interp_method_, max_diff_);
+		if ((g_.when() - q_0_.when()).as_microseconds() % Ts_.as_microseconds() == 0) {
+			trajectory_.set_sample_period(Ts_);
+		}
+
+		if (!trajectory_.validate()) {
+			LOG(Error) << "Trajectory generated by MJ was invalid.";
+		}
 		return trajectory_;
 	}
 
+	std::vector<double> MinimumJerk::at_time(const Time &instant) const {
+		std::vector<double> position(path_dim_);
+		if (coeffs_.empty()) {
+			LOG(Warning) << "Attempted to evaluate an empty MinimumJerk. Returning zeros.";
+			return position;
+		}
+		evaluate(instant, position.data(), nullptr, nullptr, nullptr);
+		return position;
+	}
+
+	bool MinimumJerk::at_time(const Time &instant, Eigen::Ref<Eigen::VectorXd> position) const {
+		if (coeffs_.empty()) {
+			LOG(Warning) << "Attempted to evaluate an empty MinimumJerk. Output not written.";
+			return false;
+		}
+		if (static_cast<std::size_t>(position.size()) != path_dim_) {
+			LOG(Warning) << "Output given to MinimumJerk::at_time() must be of size path_dim. Output not written.";
+			return false;
+		}
+		evaluate(instant, position.data(), nullptr, nullptr, nullptr);
+		return true;
+	}
+
+	bool MinimumJerk::at_time(const Time &instant, Eigen::Ref<Eigen::VectorXd> position, Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration, Eigen::Ref<Eigen::VectorXd> jerk) const {
+		if (coeffs_.empty()) {
+			LOG(Warning) << "Attempted to evaluate an empty MinimumJerk. Output not written.";
+			return false;
+		}
+		if (static_cast<std::size_t>(position.size()) != path_dim_ || static_cast<std::size_t>(velocity.size()) != path_dim_ ||
+			static_cast<std::size_t>(acceleration.size()) != path_dim_ || static_cast<std::size_t>(jerk.size()) != path_dim_) {
+			LOG(Warning) << "Outputs given to MinimumJerk::at_time() must be of size path_dim. Output not written.";
+			return false;
+		}
+		evaluate(instant, position.data(), velocity.data(), acceleration.data(), jerk.data());
+		return true;
+	}
+
+	std::size_t MinimumJerk::get_dim() const {
+		return path_dim_;
+	}
+
 	const Trajectory& MinimumJerk::update() {
 		generate_trajectory();
-		return trajectory_;
+		return trajectory();
 	}
 
 	void MinimumJerk::clear() {
 		Ts_ = Time::Zero;
 		q_0_.clear();
 		g_.clear();
+		v_0_.clear();
+		a_0_.clear();
 		tau_ = double();
 		path_dim_ = 0;
 		path_size_ = 0;
+		coeffs_.clear();
 		trajectory_.clear();
+		sampled_ = true;
 	}
 
 	bool MinimumJerk::set_start(const WayPoint &start) {
@@ -60,6 +142,8 @@ namespace robo {
 			return false;
 		}
 		q_0_ = start;
+		std::fill(v_0_.begin(), v_0_.end(), 0.0);
+		std::fill(a_0_.begin(), a_0_.end(), 0.0);
 		set_timing_parameters();
 		generate_trajectory();
 		return true;
@@ -91,15 +175,106 @@ namespace robo {
 		}
 		q_0_ = start;
 		g_ = goal;
-		T_ = g_.when().as_seconds() - q_0_.when().as_seconds();
+		std::fill(v_0_.begin(), v_0_.end(), 0.0);
+		std::fill(a_0_.begin(), a_0_.end(), 0.0);
 		set_timing_parameters();
 		generate_trajectory();
 		return true;
 	}
 
+	bool MinimumJerk::set_endpoints(const WayPoint &start, const std::vector<double> &goal, const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk) {
+		if (start.get_dim() != path_dim_) {
+			LOG(Warning) << "Path dimensions of input parameters to MinimumJerk::set_endpoints() are inconsistent. Parameters not set.";
+			return false;
+		}
+		const Time duration = shortest_duration(start.data(), start.get_dim(), goal, max_velocity, max_acceleration, max_jerk, Ts_);
+		if (duration == Time::Zero) {
+			LOG(Warning) << "Could not find a feasible duration in MinimumJerk::set_endpoints(). Parameters not set.";
+			return false;
+		}
+		return set_endpoints(start, WayPoint(start.when() + duration, goal));
+	}
+
+	Time MinimumJerk::shortest_duration(const std::vector<double> &start, const std::vector<double> &goal, const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk, const Time &sample_period) {
+		return shortest_duration(start.data(), start.size(), goal, max_velocity, max_acceleration, max_jerk, sample_period);
+	}
+
+	Time MinimumJerk::shortest_duration(const double *start, std::size_t dim, const std::vector<double> &goal, const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk, const Time &sample_period) {
+		if (goal.size() != dim || max_velocity.size() != dim || max_acceleration.size() != dim || max_jerk.size() != dim) {
+			LOG(Warning) << "Path dimensions of input parameters to MinimumJerk::shortest_duration() are inconsistent.";
+			return Time::Zero;
+		}
+		double T = 0.0;
+		for (std::size_t i = 0; i < dim; ++i) {
+			if (!(max_velocity[i] > 0.0 && max_acceleration[i] > 0.0 && max_jerk[i] > 0.0)) {
+				LOG(Warning) << "Limits given to MinimumJerk::shortest_duration() must be positive.";
+				return Time::Zero;
+			}
+			const double D = std::abs(goal[i] - start[i]);
+			T = std::max(T, 15.0 * D / (8.0 * max_velocity[i]));
+			T = std::max(T, std::sqrt(10.0 * D / (std::sqrt(3.0) * max_acceleration[i])));
+			T = std::max(T, std::cbrt(60.0 * D / max_jerk[i]));
+		}
+		// round up to whole microseconds, ignoring float noise below a nanosecond,
+		// then to whole sample periods, taking at least one of either
+		int64 duration = std::max(static_cast<int64>(std::ceil(T * 1e6 - 1e-3)), static_cast<int64>(1));
+		const int64 period = sample_period.as_microseconds();
+		if (period > 0) {
+			duration = std::max((duration + period - 1) / period, static_cast<int64>(1)) * period;
+		}
+		return microseconds(duration);
+	}
+
+	bool MinimumJerk::replan(const Time &now, const Eigen::Ref<const Eigen::VectorXd> &position, const Eigen::Ref<const Eigen::VectorXd> &velocity, const Eigen::Ref<const Eigen::VectorXd> &acceleration, const WayPoint &goal) {
+		// called every tick, so a goal that has been reached is not worth a warning
+		if (goal.when() <= now) {
+			return false;
+		}
+		if (goal.get_dim() != path_dim_ || static_cast<std::size_t>(position.size()) != path_dim_ ||
+			static_cast<std::size_t>(velocity.size()) != path_dim_ || static_cast<std::size_t>(acceleration.size()) != path_dim_) {
+			LOG(Warning) << "Path dimensions of input parameters to MinimumJerk::replan() are inconsistent. Parameters not set.";
+			return false;
+		}
+		if (Ts_ <= Time::Zero) {
+			LOG(Warning) << "Attempted to replan a MinimumJerk without a sample period. Parameters not set.";
+			return false;
+		}
+		q_0_.set_time(now);
+		q_0_.set_pos(position.data(), path_dim_);
+		std::copy(velocity.data(), velocity.data() + path_dim_, v_0_.begin());
+		std::copy(acceleration.data(), acceleration.data() + path_dim_, a_0_.begin());
+		g_ = goal;
+		// plan over exactly the time left rather than shortening it to a multiple
+		// of Ts_, which could leave no time at all
+		const int64 duration = (g_.when() - now).as_microseconds();
+		const int64 period = Ts_.as_microseconds();
+		tau_ = T_ = g_.when().as_seconds() - now.as_seconds();
+		path_size_ = static_cast<std::size_t>(duration / period) + (duration % period != 0 ? 2 : 1);
+		generate_trajectory();
+		return true;
+	}
+
+	bool MinimumJerk::set_sample_period(const Time &sample_period) {
+		if (sample_period <= Time::Zero) {
+			LOG(Warning) << "Sample period given to MinimumJerk::set_sample_period() must be positive. Sample period not set.";
+			return false;
+		}
+		if (!coeffs_.empty() && g_.when() - q_0_.when() < sample_period) {
+			LOG(Warning) << "Sample period given to MinimumJerk::set_sample_period() is longer than the movement. Sample period not set.";
+			return false;
+		}
+		Ts_ = sample_period;
+		if (!coeffs_.empty()) {
+			set_timing_parameters();
+			generate_trajectory();
+		}
+		return true;
+	}
+
 	void MinimumJerk::set_trajectory_params(Trajectory::Interp interp_method, const std::vector<double> &max_diff) {
-		trajectory_.set_interp_method(interp_method);
-		trajectory_.set_max_diff(max_diff);
+		interp_method_ = interp_method;
+		max_diff_ = max_diff;
+		sampled_ = false;
 	}
 
 	double MinimumJerk::get_tau() const {
@@ -114,63 +289,64 @@ namespace robo {
 	}
 
 	void MinimumJerk::set_timing_parameters() {
-		tau_ = g_.when().as_seconds() - q_0_.when().as_seconds();
-		if (tau_ != (int)(tau_ / Ts_.as_seconds()) * Ts_.as_seconds()) {
-			tau_ = (int)(tau_ / Ts_.as_seconds()) * Ts_.as_seconds();
-			g_.set_time(q_0_.when() + seconds(tau_));
+		const int64 duration = (g_.when() - q_0_.when()).as_microseconds();
+		const int64 period = Ts_.as_microseconds();
+		if (period <= 0) {
+			// only after clear(); the constructor and set_sample_period() reject it
+			tau_ = T_ = (g_.when() - q_0_.when()).as_seconds();
+			path_size_ = 1;
+			return;
+		}
+		if (duration % period != 0) {
+			g_.set_time(q_0_.when() + microseconds(duration - duration % period));
 			LOG(Warning) << "Trajectory duration not evenly divisible by sample period. Shortening trajectory duration.";
 		}
-		path_size_ = (std::size_t)((unsigned)std::floor(tau_ / Ts_.as_seconds())) + 1;
-		times_.resize(path_size_);
-		// times_ = linspace(q_0_.when().as_seconds(), g_.when().as_seconds(), path_size_);
-		linspace(q_0_.when().as_seconds(), g_.when().as_seconds(), times_);
+		tau_ = g_.when().as_seconds() - q_0_.when().as_seconds();
+		T_ = tau_;
+		path_size_ = static_cast<std::size_t>(duration / period) + 1;
 	}
 
 	void MinimumJerk::generate_trajectory() {
-
-		std::vector<double> a0_ = q_0_.get_pos();
-		std::vector<double> a1_(path_dim_,0.0);
-		std::vector<double> a2_(path_dim_,0.0);
-		std::vector<double> a3_(path_dim_,0.0);
-		std::vector<double> a4_(path_dim_,0.0);
-		std::vector<double> a5_(path_dim_,0.0);
-
-		std::vector<std::vector<double>> a_ { a0_, a1_, a2_, a3_, a4_, a5_ };
-
-		double xT2 = 0.0;
-		double xT3 = 0.0;
-
-		for (size_t i = 0; i < path_dim_; i++)
+		// quintic in the time since the start, matching the starting position,
+		// velocity and acceleration and ending at rest on the goal
+		const double T2 = T_ * T_;
+		const double T3 = T2 * T_;
+		coeffs_.resize(6 * path_dim_);
+		for (std::size_t i = 0; i < path_dim_; i++)
 		{
-			a_[3][i] = -(20 * a0_[i] + 20 * a1_[i] + 20 * a2_[i] - 20 * g_.get_pos()[i] - 8 * T_*a1_[i] - 16 * T_*a2_[i] + 8 * T_*xT2 + 2 * pow(T_,2) * a2_[i] - pow(T_,2) * xT3) / (2 * pow(T_,3));
-			a_[4][i] = (15 * a0_[i] + 15 * a1_[i] + 15 * a2_[i] - 15 * g_.get_pos()[i] - 7 * T_*a1_[i] - 14 * T_*a2_[i] + 7 * T_*xT2 + 2 * pow(T_,2) * a2_[i] - pow(T_,2) * xT3) / pow(T_,4);
-			a_[5][i] = -(12 * a0_[i] + 12 * a1_[i] + 12 * a2_[i] - 12 * g_.get_pos()[i] - 6 * T_*a1_[i] - 12 * T_*a2_[i] + 6 * T_*xT2 + 2 * pow(T_,2) * a2_[i] - pow(T_,2) * xT3) / (2 * pow(T_,5));
+			const double h = g_[i] - q_0_[i];
+			const double v0 = v_0_[i];
+			const double acc0 = a_0_[i];
+			double *a = coeffs_.data() + 6 * i;
+			a[0] = q_0_[i];
+			a[1] = v0;
+			a[2] = 0.5 * acc0;
+			a[3] = (20 * h - 12 * v0 * T_ - 3 * acc0 * T2) / (2 * T3);
+			a[4] = (-30 * h + 16 * v0 * T_ + 3 * acc0 * T2) / (2 * T3 * T_);
+			a[5] = (12 * h - 6 * v0 * T_ - acc0 * T2) / (2 * T3 * T2);
 		}
-		
-		// reset
-		trajectory_.resize(path_size_);
-		current_time_idx_ = 0;
 
-		// forward integration of states
-		for (std::size_t i = 0; i < path_size_; ++i) {
-			
-			std::vector<double> traj_current_(path_dim_,0.0);
-
-			for (auto j = 0; j < path_dim_; j++)
-			{
-				for (auto k = 0; k < a_.size(); k++)
-				{
-					traj_current_[j] += a_[k][j] * pow(times_[i], k);
-				}
-			}
-
-			trajectory_.add_waypoint(i, WayPoint(seconds(times_[current_time_idx_]), traj_current_));
-			current_time_idx_++;
-		}
+		// samples are taken on the next call to trajectory()
+		sampled_ = false;
+	}
 
-		if (!trajectory_.validate()) {
-			LOG(Error) << "Trajectory generated by MJ was invalid.";
-			return;
+	void MinimumJerk::evaluate(const Time &instant, double *position, double *velocity, double *acceleration, double *jerk) const {
+		// outside of the movement the endpoints are held at rest
+		double t = (instant - q_0_.when()).as_seconds();
+		const bool moving = t >= 0.0 && t <= T_;
+		t = t < 0.0 ? 0.0 : (t > T_ ? T_ : t);
+		for (std::size_t i = 0; i < path_dim_; ++i) {
+			const double *a = coeffs_.data() + 6 * i;
+			position[i] = a[0] + t * (a[1] + t * (a[2] + t * (a[3] + t * (a[4] + t * a[5]))));
+			if (velocity) {
+				velocity[i] = moving ? a[1] + t * (2 * a[2] + t * (3 * a[3] + t * (4 * a[4] + t * 5 * a[5]))) : 0.0;
+			}
+			if (acceleration) {
+				acceleration[i] = moving ? 2 * a[2] + t * (6 * a[3] + t * (12 * a[4] + t * 20 * a[5])) : 0.0;
+			}
+			if (jerk) {
+				jerk[i] = moving ? 6 * a[3] + t * (24 * a[4] + t * 60 * a[5]) : 0.0;
+			}
 		}
 	}
 
@@ -0,0 +1,262 @@
+#include <Mahi/Robo/Trajectories/MinimumJerkSpline.hpp>
+#include <Mahi/Robo/Trajectories/Search.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    MinimumJerkSpline::MinimumJerkSpline() :
+        Ts_(Time::Zero),
+        path_dim_(0),
+        sampled_(true),
+        interp_method_(Trajectory::Interp::Linear),
+        max_diff_({ INF })
+    {}
+
+    MinimumJerkSpline::MinimumJerkSpline(const Time &sample_period, const std::vector<WayPoint> &waypoints) :
+        Ts_(sample_period),
+        path_dim_(0),
+        sampled_(true),
+        interp_method_(Trajectory::Interp::Linear),
+        max_diff_({ INF })
+    {
+        set_waypoints(waypoints);
+    }
+
+    bool MinimumJerkSpline::set_waypoints(const std::vector<WayPoint> &waypoints) {
+        if (waypoints.size() < 2) {
+            LOG(Warning) << "MinimumJerkSpline requires at least two WayPoints. Path not set.";
+            return false;
+        }
+        for (std::size_t i = 1; i < waypoints.size(); ++i) {
+            if (waypoints[i].get_dim() != waypoints[0].get_dim()) {
+                LOG(Warning) << "Path dimensions of WayPoints given to MinimumJerkSpline are inconsistent. Path not set.";
+                return false;
+            }
+            if (waypoints[i].when() <= waypoints[i - 1].when()) {
+                LOG(Warning) << "WayPoints given to MinimumJerkSpline must be strictly increasing in time. Path not set.";
+                return false;
+            }
+        }
+        plan(waypoints);
+        return true;
+    }
+
+    void MinimumJerkSpline::set_sample_period(const Time &sample_period) {
+        Ts_ = sample_period;
+        sampled_ = false;
+    }
+
+    void MinimumJerkSpline::set_trajectory_params(Trajectory::Interp interp_method, const std::vector<double> &max_diff) {
+        interp_method_ = interp_method;
+        max_diff_ = max_diff;
+        sampled_ = false;
+    }
+
+    const Trajectory &MinimumJerkSpline::trajectory() {
+        if (sampled_) {
+            return trajectory_;
+        }
+        sampled_ = true;
+        if (empty() || Ts_ <= Time::Zero) {
+            LOG(Warning) << "MinimumJerkSpline needs a path and a positive sample period to be sampled. Trajectory cleared.";
+            trajectory_.clear();
+            return trajectory_;
+        }
+
+        // samples every Ts_ from the first via-point, plus the last via-point if
+        // the duration is not a multiple of Ts_
+        const int64 duration = (times_.back() - times_.front()).as_microseconds();
+        const int64 period = Ts_.as_microseconds();
+        std::size_t count = static_cast<std::size_t>(duration / period) + 1;
+        if (duration % period != 0) {
+            ++count;
+        }
+        std::vector<Time> times(count);
+        Trajectory::PositionMatrix positions(count, path_dim_);
+        std::size_t cursor = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            times[i] = std::min(times_.front() + microseconds(static_cast<int64>(i) * period), times_.back());
+            evaluate(times[i], cursor, positions.row(i).data(), nullptr, nullptr, nullptr);
+        }
+        trajectory_.set_waypoints(times, positions, interp_method_, max_diff_);
+
+        if (!trajectory_.validate()) {
+            LOG(Error) << "Trajectory generated by MinimumJerkSpline was invalid.";
+        }
+        return trajectory_;
+    }
+
+    std::vector<double> MinimumJerkSpline::at_time(const Time &instant) const {
+        std::vector<double> position(path_dim_);
+        if (empty()) {
+            LOG(Warning) << "Attempted to evaluate an empty MinimumJerkSpline. Returning empty vector.";
+            return position;
+        }
+        std::size_t cursor = 0;
+        evaluate(instant, cursor, position.data(), nullptr, nullptr, nullptr);
+        return position;
+    }
+
+    bool MinimumJerkSpline::at_time(const Time &instant, std::size_t &cursor, Eigen::Ref<Eigen::VectorXd> position) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to evaluate an empty MinimumJerkSpline. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(position.size()) != path_dim_) {
+            LOG(Warning) << "Output given to MinimumJerkSpline::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        evaluate(instant, cursor, position.data(), nullptr, nullptr, nullptr);
+        return true;
+    }
+
+    bool MinimumJerkSpline::at_time(const Time &instant, std::size_t &cursor, Eigen::Ref<Eigen::VectorXd> position, Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration, Eigen::Ref<Eigen::VectorXd> jerk) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to evaluate an empty MinimumJerkSpline. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(position.size()) != path_dim_ || static_cast<std::size_t>(velocity.size()) != path_dim_ ||
+            static_cast<std::size_t>(acceleration.size()) != path_dim_ || static_cast<std::size_t>(jerk.size()) != path_dim_) {
+            LOG(Warning) << "Outputs given to MinimumJerkSpline::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        evaluate(instant, cursor, position.data(), velocity.data(), acceleration.data(), jerk.data());
+        return true;
+    }
+
+    std::size_t MinimumJerkSpline::size() const {
+        return times_.size();
+    }
+
+    bool MinimumJerkSpline::empty() const {
+        return times_.empty();
+    }
+
+    std::size_t MinimumJerkSpline::get_dim() const {
+        return path_dim_;
+    }
+
+    void MinimumJerkSpline::clear() {
+        path_dim_ = 0;
+        times_.clear();
+        coeffs_.clear();
+        trajectory_.clear();
+        sampled_ = true;
+    }
+
+    void MinimumJerkSpline::plan(const std::vector<WayPoint> &waypoints) {
+        const std::size_t n = waypoints.size();
+        const std::size_t m = n - 2; // interior via-points
+        path_dim_ = waypoints[0].get_dim();
+        times_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            times_[i] = waypoints[i].when();
+        }
+
+        // Continuity of jerk and snap at interior via-point i couples its velocity
+        // and acceleration x_i = [v_i, a_i] to its neighbors':
+        //     A_i x_(i-1) + B_i x_i + C_i x_(i+1) = d_i
+        // with x_0 = x_(n-1) = 0 at the rest end points. The blocks depend only on
+        // the times, so one forward sweep handles every dimension at once, keeping
+        // G_i = S_i^-1 C_i and y_i = S_i^-1 (d_i - A_i y_(i-1)) for back substitution.
+        std::vector<Eigen::Matrix2d, Eigen::aligned_allocator<Eigen::Matrix2d>> G(m);
+        Eigen::MatrixXd y(2 * m, path_dim_);
+        for (std::size_t k = 0; k < m; ++k) {
+            const std::size_t i = k + 1;
+            const double L = (times_[i] - times_[i - 1]).as_seconds();
+            const double R = (times_[i + 1] - times_[i]).as_seconds();
+            const double L2 = L * L, L3 = L2 * L, R2 = R * R, R3 = R2 * R;
+            Eigen::Matrix2d A, B, C;
+            A << -24 / L2, -3 / L,
+                 168 / L3, 24 / L2;
+            B << 36 / R2 - 36 / L2, 9 / L + 9 / R,
+                 192 / L3 + 192 / R3, 36 / R2 - 36 / L2;
+            C << 24 / R2, -3 / R,
+                 168 / R3, -24 / R2;
+            Eigen::Matrix<double, 2, Eigen::Dynamic> d(2, path_dim_);
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                const double h_L = waypoints[i][j] - waypoints[i - 1][j];
+                const double h_R = waypoints[i + 1][j] - waypoints[i][j];
+                d(0, j) = 60 * h_R / R3 - 60 * h_L / L3;
+                d(1, j) = 360 * (h_R / (R3 * R) + h_L / (L3 * L));
+            }
+            if (k > 0) {
+                B -= A * G[k - 1];
+                d -= A * y.middleRows<2>(2 * (k - 1));
+            }
+            const Eigen::Matrix2d S_inv = B.inverse();
+            G[k] = S_inv * C;
+            y.middleRows<2>(2 * k) = S_inv * d;
+        }
+        for (std::size_t k = m; k-- > 1;) {
+            y.middleRows<2>(2 * (k - 1)) -= G[k - 1] * y.middleRows<2>(2 * k);
+        }
+
+        // quintic of each segment from the position, velocity and acceleration at its ends
+        coeffs_.resize(6 * path_dim_ * (n - 1));
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            const double T = (times_[i + 1] - times_[i]).as_seconds();
+            const double T2 = T * T, T3 = T2 * T;
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                const double h = waypoints[i + 1][j] - waypoints[i][j];
+                const double v0 = i > 0 ? y(2 * (i - 1), j) : 0.0;
+                const double a0 = i > 0 ? y(2 * (i - 1) + 1, j) : 0.0;
+                const double v1 = i + 1 < n - 1 ? y(2 * i, j) : 0.0;
+                const double a1 = i + 1 < n - 1 ? y(2 * i + 1, j) : 0.0;
+                double *c = coeffs_.data() + 6 * (i * path_dim_ + j);
+                c[0] = waypoints[i][j];
+                c[1] = v0;
+                c[2] = 0.5 * a0;
+                c[3] = (20 * h - (8 * v1 + 12 * v0) * T - (3 * a0 - a1) * T2) / (2 * T3);
+                c[4] = (-30 * h + (14 * v1 + 16 * v0) * T + (3 * a0 - 2 * a1) * T2) / (2 * T3 * T);
+                c[5] = (12 * h - 6 * (v1 + v0) * T - (a0 - a1) * T2) / (2 * T3 * T2);
+            }
+        }
+        sampled_ = false;
+    }
+
+    std::size_t MinimumJerkSpline::find_segment(const Time &instant, std::size_t cursor) const {
+        // callers guarantee times_.front() < instant < times_.back()
+        return detail::gallop_lower_bound(times_.data(), times_.size(), instant, cursor + 1) - 1;
+    }
+
+    void MinimumJerkSpline::evaluate(const Time &instant, std::size_t &cursor, double *position, double *velocity, double *acceleration, double *jerk) const {
+        // outside of the path the end points are held at rest
+        std::size_t segment;
+        double t;
+        bool moving = true;
+        if (instant <= times_.front()) {
+            segment = 0;
+            t = 0.0;
+            moving = instant == times_.front();
+        }
+        else if (instant >= times_.back()) {
+            segment = times_.size() - 2;
+            t = (times_.back() - times_[segment]).as_seconds();
+            moving = instant == times_.back();
+        }
+        else {
+            segment = find_segment(instant, cursor);
+            t = (instant - times_[segment]).as_seconds();
+        }
+        cursor = segment;
+        const double *c = coeffs_.data() + 6 * segment * path_dim_;
+        for (std::size_t j = 0; j < path_dim_; ++j, c += 6) {
+            position[j] = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+            if (velocity) {
+                velocity[j] = moving ? c[1] + t * (2 * c[2] + t * (3 * c[3] + t * (4 * c[4] + t * 5 * c[5]))) : 0.0;
+            }
+            if (acceleration) {
+                acceleration[j] = moving ? 2 * c[2] + t * (6 * c[3] + t * (12 * c[4] + t * 20 * c[5])) : 0.0;
+            }
+            if (jerk) {
+                jerk[j] = moving ? 6 * c[3] + t * (24 * c[4] + t * 60 * c[5]) : 0.0;
+            }
+        }
+    }
+
+}  // namespace robo
+}  // namespace mahi
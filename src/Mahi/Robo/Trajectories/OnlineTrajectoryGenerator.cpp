@@ -0,0 +1,251 @@
+#include <Mahi/Robo/Trajectories/OnlineTrajectoryGenerator.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    namespace {
+        // bisection steps locating the switch to braking within a sample period,
+        // enough to resolve it to double precision
+        const int SWITCH_ITERATIONS = 60;
+
+        // constant-jerk phases that bring a velocity and acceleration to zero
+        struct Ramp {
+            double jerk[3];
+            double duration[3];
+        };
+
+        // advances a state under constant #jerk for #t
+        void integrate(double &p, double &v, double &a, double jerk, double t) {
+            p += t * (v + t * (a / 2 + t * jerk / 6));
+            v += t * (a + t * jerk / 2);
+            a += t * jerk;
+        }
+
+        // fastest ramp within #max_acceleration and #max_jerk that brings velocity
+        // #v and acceleration #a to zero: the acceleration is ramped to a peak
+        // against the velocity, held, and ramped back out
+        Ramp ramp_to_rest(double v, double a, double max_acceleration, double max_jerk) {
+            // the velocity left once the acceleration is ramped out decides which
+            // way to go; mirror so that the peak is a negative acceleration
+            double sign = 1.0;
+            if (v + a * std::abs(a) / (2 * max_jerk) < 0.0) {
+                v = -v;
+                a = -a;
+                sign = -1.0;
+            }
+            // the ramps and hold take off v + a^2 / (2j) = peak^2 / j + peak t_hold
+            const double c = v + a * a / (2 * max_jerk);
+            const double peak = std::max(std::min(max_acceleration, std::sqrt(max_jerk * c)), -a);
+            Ramp ramp;
+            ramp.jerk[0] = -sign * max_jerk;
+            ramp.jerk[1] = 0.0;
+            ramp.jerk[2] = sign * max_jerk;
+            ramp.duration[0] = (a + peak) / max_jerk;
+            ramp.duration[1] = peak > 0.0 ? std::max((c - peak * peak / max_jerk) / peak, 0.0) : 0.0;
+            ramp.duration[2] = peak / max_jerk;
+            return ramp;
+        }
+
+        // advances a state along #ramp for #t, holding still relative to the ramp's
+        // end once it is over. Returns true if the ramp ended within #t.
+        bool follow(double &p, double &v, double &a, const Ramp &ramp, double t) {
+            const bool ends = ramp.duration[0] + ramp.duration[1] + ramp.duration[2] <= t;
+            for (int k = 0; k < 3; ++k) {
+                const double d = std::min(ramp.duration[k], t);
+                integrate(p, v, a, ramp.jerk[k], d);
+                t -= d;
+            }
+            if (t > 0.0) {
+                integrate(p, v, a, 0.0, t);
+            }
+            return ends;
+        }
+
+        // position where braking as hard as the limits allow brings a state to rest
+        double stopping_point(double p, double v, double a, double max_acceleration, double max_jerk) {
+            const Ramp ramp = ramp_to_rest(v, a, max_acceleration, max_jerk);
+            for (int k = 0; k < 3; ++k) {
+                integrate(p, v, a, ramp.jerk[k], ramp.duration[k]);
+            }
+            return p;
+        }
+
+        // advances a state for #t while it speeds up or slows down to #cruise as
+        // fast as the limits allow, and then holds that velocity
+        void drive(double &p, double &v, double &a, double cruise, double max_acceleration, double max_jerk, double t) {
+            double offset = v - cruise;
+            follow(p, offset, a, ramp_to_rest(offset, a, max_acceleration, max_jerk), t);
+            p += cruise * t;
+            v = offset + cruise;
+        }
+
+        // advances one axis by dt toward target moving at target_velocity
+        void step(double &p, double &v, double &a, double target, double target_velocity,
+                  double max_velocity, double max_acceleration, double max_jerk, double dt) {
+            // work relative to the target, which keeps its velocity over the period
+            double e = p - target;
+            double u = v - target_velocity;
+            const double miss = stopping_point(e, u, a, max_acceleration, max_jerk);
+            if (miss == 0.0 && u == 0.0 && a == 0.0) {
+                p = target + target_velocity * dt;
+                v = target_velocity;
+                return;
+            }
+            // The time-optimal trajectory drives toward the side the target is on,
+            // up to the velocity limit, until braking would stop right on the
+            // target, and then brakes. The state is sampled from it at the end of
+            // the period rather than integrated with one jerk, so it meets the
+            // target exactly and never passes it if it can stop in time. The
+            // stopping point only moves toward the target while driving, so the
+            // switch is found by bisection.
+            const bool short_of = miss < 0.0;
+            const double cruise = (short_of ? max_velocity : -max_velocity) - target_velocity;
+            const double e0 = e, u0 = u, a0 = a;
+            drive(e, u, a, cruise, max_acceleration, max_jerk, dt);
+            const double miss_after = stopping_point(e, u, a, max_acceleration, max_jerk);
+            if (miss_after == 0.0 || (miss_after < 0.0) != short_of) {
+                double lo = 0.0, hi = dt;
+                for (int k = 0; k < SWITCH_ITERATIONS; ++k) {
+                    const double mid = (lo + hi) / 2;
+                    e = e0;
+                    u = u0;
+                    a = a0;
+                    drive(e, u, a, cruise, max_acceleration, max_jerk, mid);
+                    if ((stopping_point(e, u, a, max_acceleration, max_jerk) < 0.0) == short_of) {
+                        lo = mid;
+                    }
+                    else {
+                        hi = mid;
+                    }
+                }
+                e = e0;
+                u = u0;
+                a = a0;
+                drive(e, u, a, cruise, max_acceleration, max_jerk, hi);
+                if (follow(e, u, a, ramp_to_rest(u, a, max_acceleration, max_jerk), dt - hi)) {
+                    // came to rest on the target within the period
+                    e = 0.0;
+                    u = 0.0;
+                    a = 0.0;
+                }
+            }
+            p = target + target_velocity * dt + e;
+            v = target_velocity + u;
+        }
+    }
+
+    OnlineTrajectoryGenerator::OnlineTrajectoryGenerator(const Time &sample_period, const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk) :
+        Ts_(sample_period),
+        dt_(sample_period.as_seconds()),
+        path_dim_(max_velocity.size()),
+        position_(Eigen::VectorXd::Zero(path_dim_)),
+        velocity_(Eigen::VectorXd::Zero(path_dim_)),
+        acceleration_(Eigen::VectorXd::Zero(path_dim_))
+    {
+        if (dt_ <= 0.0) {
+            LOG(Warning) << "Sample period given to OnlineTrajectoryGenerator must be positive.";
+        }
+        if (!set_limits(max_velocity, max_acceleration, max_jerk)) {
+            LOG(Warning) << "OnlineTrajectoryGenerator constructed without limits.";
+        }
+    }
+
+    bool OnlineTrajectoryGenerator::set_limits(const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk) {
+        if (max_velocity.size() != path_dim_ || max_acceleration.size() != path_dim_ || max_jerk.size() != path_dim_) {
+            LOG(Warning) << "Path dimensions of limits given to OnlineTrajectoryGenerator are inconsistent. Limits not set.";
+            return false;
+        }
+        for (std::size_t i = 0; i < path_dim_; ++i) {
+            if (!(max_velocity[i] > 0.0 && max_acceleration[i] > 0.0 && max_jerk[i] > 0.0)) {
+                LOG(Warning) << "Limits given to OnlineTrajectoryGenerator must be positive. Limits not set.";
+                return false;
+            }
+        }
+        max_velocity_ = Eigen::Map<const Eigen::VectorXd>(max_velocity.data(), path_dim_);
+        max_acceleration_ = Eigen::Map<const Eigen::VectorXd>(max_acceleration.data(), path_dim_);
+        max_jerk_ = Eigen::Map<const Eigen::VectorXd>(max_jerk.data(), path_dim_);
+        return true;
+    }
+
+    bool OnlineTrajectoryGenerator::reset(const Eigen::Ref<const Eigen::VectorXd> &position) {
+        if (static_cast<std::size_t>(position.size()) != path_dim_) {
+            LOG(Warning) << "State given to OnlineTrajectoryGenerator::reset() must be of size path_dim. State not set.";
+            return false;
+        }
+        position_ = position;
+        velocity_.setZero();
+        acceleration_.setZero();
+        return true;
+    }
+
+    bool OnlineTrajectoryGenerator::reset(const Eigen::Ref<const Eigen::VectorXd> &position, const Eigen::Ref<const Eigen::VectorXd> &velocity, const Eigen::Ref<const Eigen::VectorXd> &acceleration) {
+        if (static_cast<std::size_t>(position.size()) != path_dim_ || static_cast<std::size_t>(velocity.size()) != path_dim_ ||
+            static_cast<std::size_t>(acceleration.size()) != path_dim_) {
+            LOG(Warning) << "State given to OnlineTrajectoryGenerator::reset() must be of size path_dim. State not set.";
+            return false;
+        }
+        position_ = position;
+        velocity_ = velocity;
+        acceleration_ = acceleration;
+        return true;
+    }
+
+    bool OnlineTrajectoryGenerator::update(const Eigen::Ref<const Eigen::VectorXd> &target) {
+        if (static_cast<std::size_t>(target.size()) != path_dim_) {
+            LOG(Warning) << "Target given to OnlineTrajectoryGenerator::update() must be of size path_dim. State not updated.";
+            return false;
+        }
+        if (dt_ <= 0.0 || static_cast<std::size_t>(max_jerk_.size()) != path_dim_) {
+            LOG(Warning) << "Attempted to update an OnlineTrajectoryGenerator without a sample period and limits. State not updated.";
+            return false;
+        }
+        for (std::size_t i = 0; i < path_dim_; ++i) {
+            step(position_[i], velocity_[i], acceleration_[i], target[i], 0.0,
+                 max_velocity_[i], max_acceleration_[i], max_jerk_[i], dt_);
+        }
+        return true;
+    }
+
+    bool OnlineTrajectoryGenerator::update(const Eigen::Ref<const Eigen::VectorXd> &target, const Eigen::Ref<const Eigen::VectorXd> &target_velocity) {
+        if (static_cast<std::size_t>(target.size()) != path_dim_ || static_cast<std::size_t>(target_velocity.size()) != path_dim_) {
+            LOG(Warning) << "Target given to OnlineTrajectoryGenerator::update() must be of size path_dim. State not updated.";
+            return false;
+        }
+        if (dt_ <= 0.0 || static_cast<std::size_t>(max_jerk_.size()) != path_dim_) {
+            LOG(Warning) << "Attempted to update an OnlineTrajectoryGenerator without a sample period and limits. State not updated.";
+            return false;
+        }
+        for (std::size_t i = 0; i < path_dim_; ++i) {
+            step(position_[i], velocity_[i], acceleration_[i], target[i], target_velocity[i],
+                 max_velocity_[i], max_acceleration_[i], max_jerk_[i], dt_);
+        }
+        return true;
+    }
+
+    const Eigen::VectorXd &OnlineTrajectoryGenerator::position() const {
+        return position_;
+    }
+
+    const Eigen::VectorXd &OnlineTrajectoryGenerator::velocity() const {
+        return velocity_;
+    }
+
+    const Eigen::VectorXd &OnlineTrajectoryGenerator::acceleration() const {
+        return acceleration_;
+    }
+
+    const Time &OnlineTrajectoryGenerator::get_sample_period() const {
+        return Ts_;
+    }
+
+    std::size_t OnlineTrajectoryGenerator::get_dim() const {
+        return path_dim_;
+    }
+
+}  // namespace robo
+}  // namespace mahi
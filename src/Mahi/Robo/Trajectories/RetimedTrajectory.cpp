@@ -0,0 +1,88 @@
+#include <Mahi/Robo/Trajectories/RetimedTrajectory.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <cmath>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    RetimedTrajectory::RetimedTrajectory(const Trajectory &trajectory) :
+        trajectory_(&trajectory),
+        speed_(1.0),
+        anchor_t_(Time::Zero),
+        anchor_s_(Time::Zero)
+    {}
+
+    bool RetimedTrajectory::set_speed(double speed, const Time &now) {
+        if (speed < 0.0) {
+            LOG(Warning) << "Speed given to RetimedTrajectory::set_speed() must not be negative. Speed not set.";
+            return false;
+        }
+        anchor_s_ = trajectory_time(now);
+        anchor_t_ = now;
+        speed_ = speed;
+        time_map_ = nullptr;
+        return true;
+    }
+
+    double RetimedTrajectory::get_speed() const {
+        return speed_;
+    }
+
+    void RetimedTrajectory::set_time_map(const TimeMap &time_map) {
+        time_map_ = time_map;
+    }
+
+    void RetimedTrajectory::clear_time_map() {
+        time_map_ = nullptr;
+        speed_ = 1.0;
+        anchor_t_ = Time::Zero;
+        anchor_s_ = Time::Zero;
+    }
+
+    Time RetimedTrajectory::trajectory_time(const Time &instant) const {
+        Time s;
+        double s_dot, s_ddot;
+        map_time(instant, s, s_dot, s_ddot);
+        return s;
+    }
+
+    std::vector<double> RetimedTrajectory::at_time(const Time &instant, Trajectory::Interp interp_method) const {
+        return trajectory_->at_time(trajectory_time(instant), interp_method);
+    }
+
+    bool RetimedTrajectory::at_time(const Time &instant, std::size_t &cursor, Eigen::Ref<Eigen::VectorXd> position, Trajectory::Interp interp_method) const {
+        return trajectory_->at_time(trajectory_time(instant), cursor, position, interp_method);
+    }
+
+    bool RetimedTrajectory::at_time(const Time &instant, std::size_t &cursor, Eigen::Ref<Eigen::VectorXd> position, Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration, Trajectory::Interp interp_method) const {
+        Time s;
+        double s_dot, s_ddot;
+        map_time(instant, s, s_dot, s_ddot);
+        if (!trajectory_->at_time(s, cursor, position, velocity, acceleration, interp_method)) {
+            return false;
+        }
+        // chain rule from trajectory time to playback time
+        acceleration = acceleration * (s_dot * s_dot) + velocity * s_ddot;
+        velocity *= s_dot;
+        return true;
+    }
+
+    std::size_t RetimedTrajectory::get_dim() const {
+        return trajectory_->get_dim();
+    }
+
+    void RetimedTrajectory::map_time(const Time &instant, Time &s, double &s_dot, double &s_ddot) const {
+        if (time_map_) {
+            time_map_(instant, s, s_dot, s_ddot);
+            return;
+        }
+        const double elapsed = static_cast<double>((instant - anchor_t_).as_microseconds());
+        s = anchor_s_ + microseconds(static_cast<int64>(std::llround(speed_ * elapsed)));
+        s_dot = speed_;
+        s_ddot = 0.0;
+    }
+
+}  // namespace robo
+}  // namespace mahi
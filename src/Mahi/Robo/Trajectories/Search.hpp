@@ -0,0 +1,58 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace mahi {
+namespace robo {
+namespace detail {
+
+    /// Returns the index of the first of the #n sorted #values that is not less
+    /// than #value, galloping outward from #hint and finishing with a binary
+    /// search. Costs O(1) when #hint is already close to the answer and
+    /// O(log n) otherwise. Requires values[0] <= value <= values[n - 1].
+    template <typename T>
+    std::size_t gallop_lower_bound(const T *values, std::size_t n, const T &value, std::size_t hint) {
+        if (hint >= n) {
+            hint = n - 1;
+        }
+        std::size_t first, last;
+        std::size_t step = 1;
+        if (values[hint] < value) {
+            // gallop forward; the answer lies in (hint, last]
+            while (hint + step < n - 1 && values[hint + step] < value) {
+                hint += step;
+                step *= 2;
+            }
+            first = hint + 1;
+            last  = std::min(hint + step, n - 1);
+        }
+        else {
+            // gallop backward; the answer lies in (first - 1, hint]
+            while (hint >= step && !(values[hint - step] < value)) {
+                hint -= step;
+                step *= 2;
+            }
+            first = hint >= step ? hint - step + 1 : 0;
+            last  = hint;
+        }
+        return std::lower_bound(values + first, values + last + 1, value) - values;
+    }
+
+}  // namespace detail
+}  // namespace robo
+}  // namespace mahi
@@ -0,0 +1,102 @@
+#include <Mahi/Robo/Trajectories/StreamingTrajectory.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    StreamingTrajectory::StreamingTrajectory(std::size_t path_dim, std::size_t capacity) :
+        path_dim_(path_dim),
+        capacity_(capacity < 2 ? 2 : capacity),
+        times_(capacity_, 0),
+        positions_(capacity_ * path_dim_, 0.0),
+        head_(0),
+        tail_(0),
+        last_time_(0)
+    {
+        if (capacity < 2) {
+            LOG(Warning) << "StreamingTrajectory capacity must be at least 2. Using 2.";
+        }
+    }
+
+    bool StreamingTrajectory::push(const WayPoint &waypoint) {
+        if (waypoint.get_dim() != path_dim_) {
+            LOG(Warning) << "Input waypoint given to StreamingTrajectory contains wrong dimension. Waypoint not added.";
+            return false;
+        }
+        return commit(head_.load(std::memory_order_relaxed), waypoint.when(), waypoint.data());
+    }
+
+    bool StreamingTrajectory::push(const Time &time, const Eigen::Ref<const Eigen::VectorXd> &position) {
+        if (static_cast<std::size_t>(position.size()) != path_dim_) {
+            LOG(Warning) << "Input position given to StreamingTrajectory contains wrong dimension. Waypoint not added.";
+            return false;
+        }
+        return commit(head_.load(std::memory_order_relaxed), time, position.data());
+    }
+
+    bool StreamingTrajectory::commit(std::size_t index, const Time &time, const double *position) {
+        const std::int64_t t = time.as_microseconds();
+        if (index - tail_.load(std::memory_order_acquire) >= capacity_) {
+            return false;
+        }
+        if (index > 0 && t < last_time_) {
+            LOG(Warning) << "Input waypoint times must be monotonically increasing or not changing. Waypoint not added.";
+            return false;
+        }
+        const std::size_t slot = index % capacity_;
+        times_[slot] = t;
+        std::copy(position, position + path_dim_, positions_.begin() + slot * path_dim_);
+        last_time_ = t;
+        head_.store(index + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool StreamingTrajectory::at_time(const Time &instant, Eigen::Ref<Eigen::VectorXd> position) {
+        if (static_cast<std::size_t>(position.size()) != path_dim_) {
+            LOG(Warning) << "Output given to StreamingTrajectory::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;
+        }
+        const std::int64_t t = instant.as_microseconds();
+        // release every waypoint before the one that starts the current segment
+        while (head - tail >= 2 && times_[(tail + 1) % capacity_] <= t) {
+            ++tail;
+        }
+        tail_.store(tail, std::memory_order_release);
+        const std::size_t before = tail % capacity_;
+        Eigen::Map<const Eigen::VectorXd> q0(positions_.data() + before * path_dim_, path_dim_);
+        if (head - tail < 2 || t <= times_[before]) {
+            position = q0;
+            return true;
+        }
+        const std::size_t after = (tail + 1) % capacity_;
+        Eigen::Map<const Eigen::VectorXd> q1(positions_.data() + after * path_dim_, path_dim_);
+        const double alpha = static_cast<double>(t - times_[before]) / static_cast<double>(times_[after] - times_[before]);
+        position = q0 + alpha * (q1 - q0);
+        return true;
+    }
+
+    std::size_t StreamingTrajectory::size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t StreamingTrajectory::capacity() const {
+        return capacity_;
+    }
+
+    bool StreamingTrajectory::empty() const {
+        return size() == 0;
+    }
+
+    std::size_t StreamingTrajectory::get_dim() const {
+        return path_dim_;
+    }
+
+}  // namespace robo
+}  // namespace mahi
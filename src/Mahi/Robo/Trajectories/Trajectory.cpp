@@ -1,6 +1,12 @@
 #include <Mahi/Robo/Trajectories/Trajectory.hpp>
+#include <Mahi/Robo/Trajectories/Search.hpp>
 #include <Mahi/Util/Logging/Log.hpp>
 #include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <thread>
 #include <Mahi/Util/Math/Functions.hpp>
 
 using namespace mahi::util;
@@ -8,74 +14,585 @@ using namespace mahi::util;
 namespace mahi {
 namespace robo {
 
+    namespace {
+        // tolerance on waypoint times for them to be considered uniformly spaced,
+        // allowing for rounding of seconds() to mahi::util::Time resolution
+        const double UNIFORM_TOL = 2e-6;
+
+        // trajectories shorter than this many waypoints per thread are compressed serially
+        const std::size_t MIN_COMPRESS_CHUNK = 4096;
+
+        // spans of the Douglas-Peucker recursion dealt per thread, so that uneven
+        // spans still keep every thread busy
+        const std::size_t COMPRESS_SPANS_PER_THREAD = 8;
+
+        // writes the position at #t on the line from #initial to #final into
+        // #position, saturating to the end points outside of their times
+        void time_interpolate(const WayPoint &initial, const WayPoint &final, const Time &t, double *position) {
+            const std::size_t dim = initial.get_dim();
+            if (t <= initial.when()) {
+                std::copy(initial.data(), initial.data() + dim, position);
+                return;
+            }
+            if (t >= final.when()) {
+                std::copy(final.data(), final.data() + dim, position);
+                return;
+            }
+            const double alpha = (t.as_seconds() - initial.when().as_seconds()) / (final.when().as_seconds() - initial.when().as_seconds());
+            for (std::size_t i = 0; i < dim; ++i) {
+                position[i] = initial[i] + alpha * (final[i] - initial[i]);
+            }
+        }
+
+        // returns how many times over #tolerance the deviation #error is
+        double tolerance_ratio(double error, double tolerance) {
+            if (tolerance > 0.0) {
+                return std::abs(error) / tolerance;
+            }
+            return error != 0.0 ? INF : 0.0;
+        }
+
+        // splits span [first, last] at the waypoint farthest from the chord between
+        // its ends, relative to #tolerance, if that is beyond it. Marks the split in
+        // #keep and returns it, or returns #first if the span needs no split.
+        std::size_t split_span(const std::vector<Time> &times, const double *positions, std::size_t dim,
+                               const std::vector<double> &tolerance, std::size_t first, std::size_t last,
+                               std::vector<char> &keep)
+        {
+            if (last <= first + 1) {
+                return first;
+            }
+            const double *pa = positions + first * dim;
+            const double *pb = positions + last * dim;
+            const double span = (times[last] - times[first]).as_seconds();
+            double worst = 0.0;
+            std::size_t worst_index = first;
+            for (std::size_t i = first + 1; i < last; ++i) {
+                const double alpha = span > 0.0 ? (times[i] - times[first]).as_seconds() / span : 0.0;
+                const double *pi = positions + i * dim;
+                for (std::size_t j = 0; j < dim; ++j) {
+                    const double ratio = tolerance_ratio(pi[j] - (pa[j] + alpha * (pb[j] - pa[j])), tolerance[j]);
+                    if (ratio > worst) {
+                        worst = ratio;
+                        worst_index = i;
+                    }
+                }
+            }
+            if (worst <= 1.0) {
+                return first;
+            }
+            keep[worst_index] = 1;
+            return worst_index;
+        }
+
+        // Douglas-Peucker on waypoints [first, last]: marks in #keep the waypoints
+        // needed for linear interpolation between kept waypoints to reproduce every
+        // other waypoint within #tolerance. Only indices strictly between first and
+        // last are written, so disjoint ranges may run concurrently.
+        void douglas_peucker(const std::vector<Time> &times, const double *positions, std::size_t dim,
+                             const std::vector<double> &tolerance, std::size_t first, std::size_t last,
+                             std::vector<char> &keep)
+        {
+            std::vector<std::pair<std::size_t, std::size_t>> spans;
+            spans.push_back(std::make_pair(first, last));
+            while (!spans.empty()) {
+                const std::size_t a = spans.back().first;
+                const std::size_t b = spans.back().second;
+                spans.pop_back();
+                const std::size_t split = split_span(times, positions, dim, tolerance, a, b, keep);
+                if (split != a) {
+                    spans.push_back(std::make_pair(a, split));
+                    spans.push_back(std::make_pair(split, b));
+                }
+            }
+        }
+    }
+
     Trajectory::Trajectory() :
         is_empty_(true),
         path_dim_(0),
 		interp_method_(Interp::Linear),
-		max_diff_({ INF })
+		max_diff_({ INF }),
+		uniform_(false),
+		sample_period_(0.0),
+		coeffs_valid_(false),
+		coeffs_interp_(Interp::Linear),
+		invalid_segments_(0)
     {}
 
     Trajectory::Trajectory(std::size_t path_dim, const std::vector<WayPoint> &waypoints, Interp interp_method, const std::vector<double> &max_diff) :
-        is_empty_(false),
-        path_dim_(path_dim),
-        waypoints_(waypoints),
+        is_empty_(true),
+        path_dim_(0),
         interp_method_(interp_method),
-        times_(waypoints_.size()),
-        max_diff_(max_diff)
+        max_diff_(max_diff),
+        uniform_(false),
+        sample_period_(0.0),
+        coeffs_valid_(false),
+        coeffs_interp_(Interp::Linear),
+        invalid_segments_(0)
     {
-        //if (!check_max_diff()) {
-        //    LOG(Warning) << "Clearing Trajectory.";
-        //    clear();
-        //    return;
-        //}
-        //if (!check_waypoints()) {
-        //    LOG(Warning) << "Clearing Trajectory.";
-        //    clear();
-        //    return;
-        //}
+        set_waypoints(path_dim, waypoints, interp_method, max_diff);
+    }
 
-        for (std::size_t i = 0; i < waypoints_.size(); ++i) {
-            times_[i] = waypoints_[i].when();
-        }
+    Trajectory::Trajectory(const std::vector<Time> &times, const Eigen::Ref<const PositionMatrix> &positions, Interp interp_method, const std::vector<double> &max_diff) :
+        is_empty_(true),
+        path_dim_(0),
+        interp_method_(interp_method),
+        max_diff_(max_diff),
+        uniform_(false),
+        sample_period_(0.0),
+        coeffs_valid_(false),
+        coeffs_interp_(Interp::Linear),
+        invalid_segments_(0)
+    {
+        set_waypoints(times, positions, interp_method, max_diff);
     }
 
     std::vector<double> Trajectory::at_time(const Time &instant, Interp interp_method) const {
+        std::size_t cursor = 0;
+        return at_time(instant, cursor, interp_method);
+    }
+
+    std::vector<double> Trajectory::at_time(const Time &instant, std::size_t &cursor, Interp interp_method) const {
         if (empty()) {
             LOG(Warning) << "Attempted to access an empty trajectory at a certain time. Returning empty vector.";
             return std::vector<double>();
         }
-        if (instant < times_.front()) {
-            return waypoints_.front().get_pos();
+        std::vector<double> position(path_dim_);
+        if (!evaluate(instant, cursor, interp_method, position.data())) {
+            return std::vector<double>();
         }
-        else if (instant > times_.back()) {
-            return waypoints_.back().get_pos();
+        return position;
+    }
+
+    bool Trajectory::at_time(const Time &instant, Eigen::Ref<Eigen::VectorXd> position, Interp interp_method) const {
+        std::size_t cursor = 0;
+        return at_time(instant, cursor, position, interp_method);
+    }
+
+    bool Trajectory::at_time(const Time &instant, std::size_t &cursor, Eigen::Ref<Eigen::VectorXd> position, Interp interp_method) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to access an empty trajectory at a certain time. Output not written.";
+            return false;
         }
-        std::size_t after = std::distance(times_.begin(), std::find_if(times_.begin(), times_.end(), [instant](Time t) {return t >= instant; }));
-        std::size_t before = after > 0 ? after - 1 : after;
-        switch (interp_method) {
-        case Interp::Linear:
-            // std::cout <<instant.as_seconds() << ": " << before << ", " << waypoints_[before][0] << " -- " << after << ", " << waypoints_[after][0] << "\n";
-            return linear_time_interpolate(waypoints_[before], waypoints_[after], instant).get_pos();
-            break;
-        default:
-            LOG(Error) << "Invalid interpolation method used in Trajectory::at_time().";
-            return std::vector<double>();
+        if (static_cast<std::size_t>(position.size()) != path_dim_) {
+            LOG(Warning) << "Output given to Trajectory::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        return evaluate(instant, cursor, interp_method, position.data());
+    }
+
+    bool Trajectory::at_time(const Time &instant, Eigen::Ref<Eigen::VectorXd> position, Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration, Interp interp_method) const {
+        std::size_t cursor = 0;
+        return at_time(instant, cursor, position, velocity, acceleration, interp_method);
+    }
+
+    bool Trajectory::at_time(const Time &instant, std::size_t &cursor, Eigen::Ref<Eigen::VectorXd> position, Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration, Interp interp_method) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to access an empty trajectory at a certain time. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(position.size()) != path_dim_ || static_cast<std::size_t>(velocity.size()) != path_dim_ || static_cast<std::size_t>(acceleration.size()) != path_dim_) {
+            LOG(Warning) << "Outputs given to Trajectory::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        return evaluate(instant, cursor, interp_method, position.data(), velocity.data(), acceleration.data());
+    }
+
+    bool Trajectory::sample_many(const std::vector<Time> &instants, Eigen::Ref<PositionMatrix> positions, Interp interp_method) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to sample an empty trajectory. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(positions.rows()) != instants.size() || static_cast<std::size_t>(positions.cols()) != path_dim_) {
+            LOG(Warning) << "Output given to Trajectory::sample_many() must be of size instants.size() x path_dim. Output not written.";
+            return false;
+        }
+        // a single cursor carried across the queries turns sorted instants into
+        // one merged sweep over the waypoints
+        std::size_t cursor = 0;
+        for (std::size_t k = 0; k < instants.size(); ++k) {
+            if (!evaluate(instants[k], cursor, interp_method, positions.row(k).data())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Trajectory::PositionMatrix Trajectory::sample_many(const std::vector<Time> &instants, Interp interp_method) const {
+        PositionMatrix positions(instants.size(), path_dim_);
+        if (!sample_many(instants, positions, interp_method)) {
+            return PositionMatrix();
+        }
+        return positions;
+    }
+
+    Trajectory Trajectory::resample(const Time &sample_period, Interp interp_method) const {
+        Trajectory resampled;
+        if (empty()) {
+            LOG(Warning) << "Attempted to resample an empty trajectory. Returning empty Trajectory.";
+            return resampled;
+        }
+        if (sample_period <= Time::Zero) {
+            LOG(Warning) << "Sample period given to Trajectory::resample() must be positive. Returning empty Trajectory.";
+            return resampled;
+        }
+        if (!is_prepared(interp_method)) {
+            // solve the spline on a copy rather than in this const trajectory
+            Trajectory prepared(*this);
+            prepared.prepare(interp_method);
+            return prepared.resample(sample_period, interp_method);
+        }
+        const int64 t0 = times_.front().as_microseconds();
+        const int64 Ts = sample_period.as_microseconds();
+        const std::size_t n = static_cast<std::size_t>((times_.back().as_microseconds() - t0) / Ts) + 1;
+        std::vector<Time> times(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            times[k] = microseconds(t0 + static_cast<int64>(k) * Ts);
+        }
+        PositionMatrix positions(n, path_dim_);
+        sample_many(times, positions, interp_method);
+        // set_waypoints() also checks the segments and solves any cubic spline
+        resampled.set_waypoints(times, positions, interp_method_, max_diff_);
+        resampled.set_sample_period(sample_period);
+        return resampled;
+    }
+
+    Trajectory Trajectory::compress(const std::vector<double> &tolerance, Interp interp_method, std::size_t num_threads) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to compress an empty trajectory. Returning empty Trajectory.";
+            return Trajectory();
+        }
+        if (tolerance.size() != 1 && tolerance.size() != path_dim_) {
+            LOG(Warning) << "Tolerance given to Trajectory::compress() must be of size 1 or path_dim. Returning empty Trajectory.";
+            return Trajectory();
+        }
+        if (!is_prepared(interp_method)) {
+            // solve the spline on a copy rather than in this const trajectory
+            Trajectory prepared(*this);
+            prepared.prepare(interp_method);
+            return prepared.compress(tolerance, interp_method, num_threads);
+        }
+        const std::size_t n = size();
+        std::vector<double> tol(path_dim_);
+        for (std::size_t j = 0; j < path_dim_; ++j) {
+            tol[j] = tolerance.size() == 1 ? tolerance[0] : tolerance[j];
+        }
+        std::vector<char> keep(n, 0);
+        keep.front() = 1;
+        keep.back() = 1;
+
+        if (interp_method == Interp::Linear) {
+            if (num_threads == 0) {
+                num_threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            num_threads = std::max<std::size_t>(1, std::min(num_threads, n / MIN_COMPRESS_CHUNK));
+            if (num_threads == 1) {
+                douglas_peucker(times_, positions_.data(), path_dim_, tol, 0, n - 1, keep);
+            }
+            else {
+                // Each span is split the same way whichever thread takes it and in
+                // whatever order, so expanding the top of the recursion here and
+                // handing the remaining spans to the threads keeps exactly the
+                // waypoints the serial pass would.
+                std::vector<std::pair<std::size_t, std::size_t>> spans(1, std::make_pair(std::size_t(0), n - 1));
+                std::size_t next = 0;
+                while (next < spans.size() && spans.size() - next < COMPRESS_SPANS_PER_THREAD * num_threads) {
+                    const std::size_t a = spans[next].first;
+                    const std::size_t b = spans[next].second;
+                    ++next;
+                    const std::size_t split = split_span(times_, positions_.data(), path_dim_, tol, a, b, keep);
+                    if (split != a) {
+                        spans.push_back(std::make_pair(a, split));
+                        spans.push_back(std::make_pair(split, b));
+                    }
+                }
+                std::atomic<std::size_t> claimed(next);
+                auto work = [&]() {
+                    for (std::size_t k = claimed++; k < spans.size(); k = claimed++) {
+                        douglas_peucker(times_, positions_.data(), path_dim_, tol, spans[k].first, spans[k].second, keep);
+                    }
+                };
+                std::vector<std::thread> workers;
+                workers.reserve(num_threads - 1);
+                for (std::size_t k = 1; k < num_threads; ++k) {
+                    workers.push_back(std::thread(work));
+                }
+                work();
+                for (std::size_t k = 0; k < workers.size(); ++k) {
+                    workers[k].join();
+                }
+            }
+        }
+
+        std::vector<Time> times;
+        std::vector<double> positions;
+        Trajectory compressed;
+        while (true) {
+            times.clear();
+            positions.clear();
+            for (std::size_t i = 0; i < n; ++i) {
+                if (keep[i]) {
+                    times.push_back(times_[i]);
+                    positions.insert(positions.end(), row(i), row(i) + path_dim_);
+                }
+            }
+            compressed.set_waypoints(times, Eigen::Map<const PositionMatrix>(positions.data(), times.size(), path_dim_),
+                                     interp_method, max_diff_);
+            if (interp_method == Interp::Linear) {
+                break;
+            }
+            // Removing a knot changes the spline everywhere, so every dropped
+            // waypoint is checked against the spline through the kept ones, and the
+            // one with the largest deviation in each span that is out of tolerance
+            // is re-inserted. Starting from the end points alone, the spans roughly
+            // halve each pass, as in Douglas-Peucker.
+            std::vector<double> q(path_dim_);
+            std::size_t cursor = 0;
+            std::size_t worst_index = 0;
+            double worst = 0.0;
+            bool refined = false;
+            for (std::size_t i = 1; i < n; ++i) {
+                if (keep[i]) {
+                    if (worst > 1.0) {
+                        keep[worst_index] = 1;
+                        refined = true;
+                    }
+                    worst = 0.0;
+                    continue;
+                }
+                compressed.evaluate(times_[i], cursor, interp_method, q.data());
+                for (std::size_t j = 0; j < path_dim_; ++j) {
+                    const double ratio = tolerance_ratio(q[j] - row(i)[j], tol[j]);
+                    if (ratio > worst) {
+                        worst = ratio;
+                        worst_index = i;
+                    }
+                }
+            }
+            if (!refined) {
+                break;
+            }
+        }
+        return compressed;
+    }
+
+    Trajectory Trajectory::time_optimal(const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to retime an empty trajectory. Returning empty Trajectory.";
+            return Trajectory();
+        }
+        if ((max_velocity.size() != 1 && max_velocity.size() != path_dim_) || (max_acceleration.size() != 1 && max_acceleration.size() != path_dim_)) {
+            LOG(Warning) << "Limits given to Trajectory::time_optimal() must be of size 1 or path_dim. Returning empty Trajectory.";
+            return Trajectory();
+        }
+        std::vector<double> v_max(path_dim_), a_max(path_dim_);
+        for (std::size_t j = 0; j < path_dim_; ++j) {
+            const double max_diff_j = j >= max_diff_.size() ? max_diff_.back() : max_diff_[j];
+            v_max[j] = std::min(max_velocity.size() == 1 ? max_velocity[0] : max_velocity[j], max_diff_j);
+            a_max[j] = max_acceleration.size() == 1 ? max_acceleration[0] : max_acceleration[j];
+            if (!(v_max[j] > 0.0) || !(a_max[j] > 0.0)) {
+                LOG(Warning) << "Limits given to Trajectory::time_optimal() must be positive. Returning empty Trajectory.";
+                return Trajectory();
+            }
+        }
+
+        // the path grid skips repeated positions, which take no time to traverse
+        const std::size_t n = size();
+        std::vector<std::size_t> grid(1, 0);
+        for (std::size_t i = 1; i < n; ++i) {
+            if (!std::equal(row(i), row(i) + path_dim_, row(grid.back()))) {
+                grid.push_back(i);
+            }
+        }
+        const std::size_t m = grid.size();
+
+        // arc length and finite-difference path derivatives q' and q'' on the grid
+        std::vector<double> s(m, 0.0);
+        for (std::size_t k = 1; k < m; ++k) {
+            double d2 = 0.0;
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                const double d = row(grid[k])[j] - row(grid[k - 1])[j];
+                d2 += d * d;
+            }
+            s[k] = s[k - 1] + std::sqrt(d2);
+        }
+        std::vector<double> dq(m * path_dim_, 0.0), ddq(m * path_dim_, 0.0);
+        for (std::size_t k = 0; k < m && m > 1; ++k) {
+            const std::size_t k0 = k == 0 ? 0 : k - 1;
+            const std::size_t k1 = k + 1 == m ? k : k + 1;
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                dq[k * path_dim_ + j] = (row(grid[k1])[j] - row(grid[k0])[j]) / (s[k1] - s[k0]);
+                if (k0 < k && k < k1) {
+                    ddq[k * path_dim_ + j] = 2.0 * ((row(grid[k1])[j] - row(grid[k])[j]) / (s[k1] - s[k]) -
+                                                    (row(grid[k])[j] - row(grid[k0])[j]) / (s[k] - s[k0])) / (s[k1] - s[k0]);
+                }
+            }
+        }
+
+        // at grid point k, each dimension j bounds the path acceleration u = s''
+        // through -a_j <= q'_j u + q''_j x <= a_j, where x = s'^2; these are
+        // returned as half-planes alpha u + beta x <= a
+        std::vector<double> alpha(2 * path_dim_), beta(2 * path_dim_), bound(2 * path_dim_);
+        auto constraints = [&](std::size_t k) {
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                alpha[2 * j] = dq[k * path_dim_ + j];
+                beta[2 * j] = ddq[k * path_dim_ + j];
+                alpha[2 * j + 1] = -alpha[2 * j];
+                beta[2 * j + 1] = -beta[2 * j];
+                bound[2 * j] = bound[2 * j + 1] = a_max[j];
+            }
+        };
+        auto u_max = [&](double x) {
+            double u = INF;
+            for (std::size_t c = 0; c < alpha.size(); ++c) {
+                if (alpha[c] > 0.0) {
+                    u = std::min(u, (bound[c] - beta[c] * x) / alpha[c]);
+                }
+            }
+            return u;
+        };
+        auto u_min = [&](double x) {
+            double u = -INF;
+            for (std::size_t c = 0; c < alpha.size(); ++c) {
+                if (alpha[c] < 0.0) {
+                    u = std::max(u, (bound[c] - beta[c] * x) / alpha[c]);
+                }
+            }
+            return u;
+        };
+
+        // maximum velocity curve: the largest x at each grid point for which the
+        // velocity limits hold and some path acceleration is feasible
+        std::vector<double> x_max(m, INF);
+        for (std::size_t k = 0; k < m; ++k) {
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                const double d = dq[k * path_dim_ + j];
+                if (d != 0.0) {
+                    x_max[k] = std::min(x_max[k], v_max[j] * v_max[j] / (d * d));
+                }
+                // the neighboring segment directions too, so the average velocity
+                // over every segment stays within max_diff
+                for (std::size_t k1 = k == 0 ? 0 : k - 1; k1 < k + 1 && k1 + 1 < m; ++k1) {
+                    const double d1 = (row(grid[k1 + 1])[j] - row(grid[k1])[j]) / (s[k1 + 1] - s[k1]);
+                    if (d1 != 0.0) {
+                        x_max[k] = std::min(x_max[k], v_max[j] * v_max[j] / (d1 * d1));
+                    }
+                }
+            }
+            constraints(k);
+            for (std::size_t c1 = 0; c1 < alpha.size(); ++c1) {
+                if (alpha[c1] == 0.0 && beta[c1] > 0.0) {
+                    x_max[k] = std::min(x_max[k], bound[c1] / beta[c1]);
+                }
+                if (alpha[c1] <= 0.0) {
+                    continue;
+                }
+                for (std::size_t c2 = 0; c2 < alpha.size(); ++c2) {
+                    if (alpha[c2] >= 0.0) {
+                        continue;
+                    }
+                    // lower bound of c2 must not exceed upper bound of c1
+                    const double slope = beta[c1] / alpha[c1] - beta[c2] / alpha[c2];
+                    if (slope > 0.0) {
+                        x_max[k] = std::min(x_max[k], (bound[c1] / alpha[c1] - bound[c2] / alpha[c2]) / slope);
+                    }
+                }
+            }
+        }
+        x_max.front() = 0.0;
+        x_max.back() = 0.0;
+
+        // backward pass: the largest x from which the path can still brake down
+        // to the next grid point's limit
+        std::vector<double> x(x_max);
+        for (std::size_t k = m - 1; k-- > 0;) {
+            const double ds = s[k + 1] - s[k];
+            constraints(k);
+            for (std::size_t c = 0; c < alpha.size(); ++c) {
+                if (alpha[c] < 0.0) {
+                    const double slope = 1.0 - 2.0 * ds * beta[c] / alpha[c];
+                    if (slope > 0.0) {
+                        x[k] = std::min(x[k], (x[k + 1] - 2.0 * ds * bound[c] / alpha[c]) / slope);
+                    }
+                }
+            }
+        }
+
+        // forward pass: accelerate as hard as possible under the backward limit
+        for (std::size_t k = 0; k + 1 < m; ++k) {
+            const double ds = s[k + 1] - s[k];
+            constraints(k);
+            x[k + 1] = std::max(0.0, std::min(x[k + 1], x[k] + 2.0 * ds * u_max(x[k])));
+        }
+
+        // integrate the segment durations, rounding up so no limit is exceeded
+        std::vector<Time> times(n, times_.front());
+        std::size_t k = 0;
+        for (std::size_t i = 1; i < n; ++i) {
+            times[i] = times[i - 1];
+            if (k + 1 < m && grid[k + 1] == i) {
+                const double ds = s[k + 1] - s[k];
+                const double speed = std::sqrt(x[k]) + std::sqrt(x[k + 1]);
+                double dt;
+                if (speed > 0.0) {
+                    dt = 2.0 * ds / speed;
+                }
+                else {
+                    // a single segment starting and ending at rest: accelerate for
+                    // half of it and brake for the other half
+                    constraints(k);
+                    const double u = std::min(u_max(0.0), -u_min(0.0));
+                    dt = 2.0 * std::sqrt(ds / u);
+                    for (std::size_t j = 0; j < path_dim_; ++j) {
+                        dt = std::max(dt, std::abs(row(i)[j] - row(grid[k])[j]) / v_max[j]);
+                    }
+                }
+                times[i] += microseconds(static_cast<int64>(std::ceil(dt * 1e6)));
+                ++k;
+            }
         }
+        return Trajectory(times, positions(), interp_method_, max_diff_);
     }
 
-    const WayPoint &Trajectory::operator[](std::size_t index) const {
-		if (index >= waypoints_.size()) {
+    Eigen::Map<const Eigen::RowVectorXd> Trajectory::position(std::size_t index) const {
+		if (index >= size()) {
+			LOG(Warning) << "Index for Trajectory outside of range. Returning last position.";
+			if (times_.empty()) {
+				return Eigen::Map<const Eigen::RowVectorXd>(nullptr, 0);
+			}
+			index = size() - 1;
+		}
+		return Eigen::Map<const Eigen::RowVectorXd>(row(index), path_dim_);
+    }
+
+    WayPoint Trajectory::waypoint(std::size_t index) const {
+		if (index >= size()) {
 			LOG(Warning) << "Index for Trajectory outside of range. Returning last WayPoint.";
-			return waypoints_.back();
+			return back();
 		}
-        return waypoints_[index];
+        return WayPoint(times_[index], row(index), path_dim_);
+    }
+
+    const WayPoint Trajectory::operator[](std::size_t index) const {
+        return waypoint(index);
     }
 
 	bool Trajectory::add_waypoint(std::size_t index, const WayPoint &waypoint) {
-		if (index >= waypoints_.size()) {
+		if (index >= size()) {
 			LOG(Warning) << "Index for Trajectory outside of range. WayPoint not added.";
 			return false;
 		}
+		if (waypoint.get_dim() != path_dim_) {
+			if (!is_empty_) {
+				LOG(Warning) << "Input waypoint given to Trajectory contains wrong dimension. Waypoint not added.";
+				return false;
+			}
+			// first waypoint of an empty trajectory sets the dimension of the storage
+			path_dim_ = waypoint.get_dim();
+			positions_.assign(size() * path_dim_, 0.0);
+			check_segments();
+		}
 		//if (!is_empty_) {
 		//	if (waypoint.get_dim() != path_dim_) {
 		//		LOG(Warning) << "Input waypoint given to Trajectory contains wrong dimension. Waypoint not added.";
@@ -86,25 +603,54 @@ namespace robo {
 		//		return false;
 		//	}
 		//}
+		if (uniform_ && std::abs((waypoint.when() - times_.front()).as_seconds() - index * sample_period_) > UNIFORM_TOL) {
+			uniform_ = false;
+		}
 		is_empty_ = false;
-		path_dim_ = waypoint.get_dim();
-		waypoints_[index] = waypoint;
+		coeffs_valid_ = false;
 		times_[index] = waypoint.when();
+		std::copy(waypoint.data(), waypoint.data() + path_dim_, row(index));
+		if (index > 0) {
+			update_segment(index - 1);
+		}
+		if (index + 1 < size()) {
+			update_segment(index);
+		}
 		return true;
 	}
 
-	const WayPoint& Trajectory::front() const {
-		return waypoints_.front();
+	const WayPoint Trajectory::front() const {
+		if (times_.empty()) {
+			return WayPoint();
+		}
+		return waypoint(0);
+	}
+
+	const WayPoint Trajectory::back() const {
+		if (times_.empty()) {
+			return WayPoint();
+		}
+		return waypoint(size() - 1);
+	}
+
+	const std::vector<Time> &Trajectory::times() const {
+		return times_;
 	}
 
-	const WayPoint& Trajectory::back() const {
-		return waypoints_.back();
+	Eigen::Map<const Trajectory::PositionMatrix> Trajectory::positions() const {
+		return Eigen::Map<const PositionMatrix>(positions_.data(), times_.size(), path_dim_);
 	}
 
     bool Trajectory::set_waypoints(std::size_t path_dim, const std::vector<WayPoint>& waypoints, Interp interp_method, const std::vector<double> &max_diff) {
+        for (std::size_t i = 0; i < waypoints.size(); ++i) {
+            if (waypoints[i].get_dim() != path_dim) {
+                LOG(Warning) << "Input waypoints given to Trajectory contains Points of the wrong size. Clearing Trajectory.";
+                clear();
+                return false;
+            }
+        }
         is_empty_ = waypoints.empty();
         path_dim_ = path_dim;
-        waypoints_ = waypoints;
         interp_method_ = interp_method;
         max_diff_ = max_diff;
         //if (!check_max_diff()) {
@@ -117,19 +663,53 @@ namespace robo {
         //    clear();
         //    return false;
         //}
-        times_.resize(waypoints_.size());
-        for (std::size_t i = 0; i < waypoints_.size(); ++i) {
-            times_[i] = waypoints_[i].when();
+        times_.resize(waypoints.size());
+        positions_.resize(waypoints.size() * path_dim_);
+        for (std::size_t i = 0; i < waypoints.size(); ++i) {
+            times_[i] = waypoints[i].when();
+            std::copy(waypoints[i].data(), waypoints[i].data() + path_dim_, row(i));
+        }
+        detect_uniform();
+        check_segments();
+        coeffs_valid_ = false;
+        if (interp_method_ != Interp::Linear) {
+            compute_spline(interp_method_);
+        }
+        return true;
+    }
+
+    bool Trajectory::set_waypoints(const std::vector<Time> &times, const Eigen::Ref<const PositionMatrix> &positions, Interp interp_method, const std::vector<double> &max_diff) {
+        if (static_cast<std::size_t>(positions.rows()) != times.size()) {
+            LOG(Warning) << "Number of times and positions given to Trajectory must match. Clearing Trajectory.";
+            clear();
+            return false;
+        }
+        is_empty_ = times.empty();
+        path_dim_ = positions.cols();
+        interp_method_ = interp_method;
+        max_diff_ = max_diff;
+        times_ = times;
+        positions_.resize(times_.size() * path_dim_);
+        Eigen::Map<PositionMatrix>(positions_.data(), times_.size(), path_dim_) = positions;
+        detect_uniform();
+        check_segments();
+        coeffs_valid_ = false;
+        if (interp_method_ != Interp::Linear) {
+            compute_spline(interp_method_);
         }
         return true;
     }
 
     void Trajectory::set_interp_method(Interp interp_method) {
         interp_method_ = interp_method;
+        if (interp_method_ != Interp::Linear && !empty()) {
+            compute_spline(interp_method_);
+        }
     }
 
     void Trajectory::set_max_diff(const std::vector<double> &max_diff) {
         max_diff_ = max_diff;
+        check_segments();
 		//if (!is_empty_) {
 		//	if (!check_max_diff()) {
 		//		LOG(Warning) << "Parameter max_diff not changed.";
@@ -138,18 +718,43 @@ namespace robo {
 		//}
     }
 
+    void Trajectory::set_sample_period(const Time &sample_period) {
+        sample_period_ = sample_period.as_seconds();
+        uniform_ = times_.size() > 1 && sample_period_ > 0.0;
+    }
+
+    bool Trajectory::is_uniform() const {
+        return uniform_;
+    }
+
     bool Trajectory::empty() const {
         return is_empty_;
     }
 
     std::size_t Trajectory::size() const {
-        return waypoints_.size();
+        return times_.size();
     }
 
 	void Trajectory::resize(std::size_t new_size) {
-		if (waypoints_.size() != new_size) {
-			waypoints_.resize(new_size);
+		if (size() != new_size) {
+			if (new_size > size() || new_size < 2) {
+				uniform_ = false;
+			}
+			const std::size_t old_size = size();
 			times_.resize(new_size);
+			positions_.resize(new_size * path_dim_);
+			coeffs_valid_ = false;
+			// drop the segments that no longer exist, then check the new ones
+			while (segment_valid_.size() > (new_size > 0 ? new_size - 1 : 0)) {
+				if (!segment_valid_.back()) {
+					invalid_segments_--;
+				}
+				segment_valid_.pop_back();
+			}
+			segment_valid_.resize(new_size > 0 ? new_size - 1 : 0, 1);
+			for (std::size_t i = old_size > 0 ? old_size - 1 : 0; i + 1 < new_size; ++i) {
+				update_segment(i);
+			}
 		}
 	}
 
@@ -160,13 +765,21 @@ namespace robo {
     void Trajectory::clear() {
         is_empty_ = true;
         path_dim_ = 0;
-        waypoints_.clear();
         times_.clear();
+        positions_.clear();
+        uniform_ = false;
+        coeffs_valid_ = false;
+        segment_valid_.clear();
+        invalid_segments_ = 0;
     }
 
     bool Trajectory::push_back(const WayPoint &waypoint) {        
         if (is_empty_) {
-            path_dim_ = waypoint.get_dim();
+            if (waypoint.get_dim() != path_dim_) {
+                path_dim_ = waypoint.get_dim();
+                positions_.assign(size() * path_dim_, 0.0);
+                check_segments();
+            }
 			//if (!check_max_diff()) {
 			//	LOG(Warning) << "Parameter max_diff reset to default.";
 			//	max_diff_ = { INF };
@@ -183,9 +796,25 @@ namespace robo {
 			//	LOG(Warning) << "Input waypoint times must be monotonically increasing or not changing. Waypoint not added.";
 			//	return false;
 			//}
+			if (waypoint.get_dim() != path_dim_) {
+				LOG(Warning) << "Input waypoint given to Trajectory contains wrong dimension. Waypoint not added.";
+				return false;
+			}
         }
-		waypoints_.push_back(waypoint);
 		times_.push_back(waypoint.when());
+		positions_.insert(positions_.end(), waypoint.data(), waypoint.data() + path_dim_);
+		coeffs_valid_ = false;
+		if (size() > 1) {
+			segment_valid_.push_back(1);
+			update_segment(size() - 2);
+		}
+		if (times_.size() == 2) {
+			sample_period_ = (times_[1] - times_[0]).as_seconds();
+			uniform_ = sample_period_ > 0.0;
+		}
+		else if (uniform_ && std::abs((waypoint.when() - times_.front()).as_seconds() - (times_.size() - 1) * sample_period_) > UNIFORM_TOL) {
+			uniform_ = false;
+		}
 		return true;
     }
 
@@ -194,7 +823,14 @@ namespace robo {
 		if (!check_max_diff()) {
 			valid = false;
 		}
-		if (!check_waypoints()) {
+		if (empty()) {
+			LOG(Warning) << "Attempted to validate an empty trajectory. Returning false.";
+			return false;
+		}
+		// segment validity is maintained as waypoints change, so the full scan is
+		// only needed to report what is wrong
+		if (invalid_segments_ > 0) {
+			check_waypoints();
 			valid = false;
 		}
 		return valid;
@@ -202,11 +838,251 @@ namespace robo {
 
 	std::ostream& operator<<(std::ostream& os, const Trajectory& trajectory) {
 		for (std::size_t i = 0; i < trajectory.size(); ++i) {
-			os << trajectory[i];
+			os << trajectory.waypoint(i);
 		}
 		return os;
 	}
 
+    bool Trajectory::evaluate(const Time &instant, std::size_t &cursor, Interp interp_method, double *position, double *velocity, double *acceleration) const {
+        if (instant < times_.front() || instant > times_.back() || size() == 1) {
+            // the trajectory holds its end points outside of its time range
+            const double *p = instant < times_.front() ? row(0) : row(size() - 1);
+            std::copy(p, p + path_dim_, position);
+            if (velocity) {
+                std::fill(velocity, velocity + path_dim_, 0.0);
+            }
+            if (acceleration) {
+                std::fill(acceleration, acceleration + path_dim_, 0.0);
+            }
+            return true;
+        }
+        if (uniform_) {
+            cursor = static_cast<std::size_t>(std::ceil((instant - times_.front()).as_seconds() / sample_period_));
+        }
+        std::size_t after = std::max(find_after(instant, cursor), std::size_t(1));
+        std::size_t before = after - 1;
+        cursor = after;
+        switch (interp_method) {
+        case Interp::Linear:
+            linear_interpolate(before, after, instant, position, velocity, acceleration);
+            return true;
+        case Interp::CubicNatural:
+        case Interp::CubicClamped:
+            // queries never solve the spline themselves; see prepare()
+            if (!is_prepared(interp_method)) {
+                LOG(Warning) << "Cubic interpolation requested from a Trajectory whose spline is not prepared for it. Call prepare() first. Output not written.";
+                return false;
+            }
+            cubic_interpolate(before, instant, position, velocity, acceleration);
+            return true;
+        default:
+            LOG(Error) << "Invalid interpolation method used in Trajectory::at_time().";
+            return false;
+        }
+    }
+
+    const double *Trajectory::row(std::size_t index) const {
+        return positions_.data() + index * path_dim_;
+    }
+
+    double *Trajectory::row(std::size_t index) {
+        return positions_.data() + index * path_dim_;
+    }
+
+    void Trajectory::linear_interpolate(std::size_t before, std::size_t after, const Time &instant, double *position, double *velocity, double *acceleration) const {
+        const double *p0 = row(before);
+        const double *p1 = row(after);
+        const double dt = (times_[after] - times_[before]).as_seconds();
+        if (acceleration) {
+            std::fill(acceleration, acceleration + path_dim_, 0.0);
+        }
+        if (dt <= 0.0) {
+            std::copy(p0, p0 + path_dim_, position);
+            if (velocity) {
+                std::fill(velocity, velocity + path_dim_, 0.0);
+            }
+            return;
+        }
+        Eigen::Map<const Eigen::VectorXd> q0(p0, path_dim_);
+        Eigen::Map<const Eigen::VectorXd> q1(p1, path_dim_);
+        const double alpha = (instant - times_[before]).as_seconds() / dt;
+        Eigen::Map<Eigen::VectorXd>(position, path_dim_) = q0 + alpha * (q1 - q0);
+        if (velocity) {
+            Eigen::Map<Eigen::VectorXd>(velocity, path_dim_) = (q1 - q0) / dt;
+        }
+    }
+
+    void Trajectory::cubic_interpolate(std::size_t before, const Time &instant, double *position, double *velocity, double *acceleration) const {
+        const double tau = (instant - times_[before]).as_seconds();
+        const double *c = coeffs_.data() + before * path_dim_ * 4;
+        for (std::size_t i = 0; i < path_dim_; ++i, c += 4) {
+            position[i] = c[0] + tau * (c[1] + tau * (c[2] + tau * c[3]));
+            if (velocity) {
+                velocity[i] = c[1] + tau * (2.0 * c[2] + tau * 3.0 * c[3]);
+            }
+            if (acceleration) {
+                acceleration[i] = 2.0 * c[2] + tau * 6.0 * c[3];
+            }
+        }
+    }
+
+    void Trajectory::prepare(Interp interp_method) {
+        if (!empty() && !is_prepared(interp_method)) {
+            compute_spline(interp_method);
+        }
+    }
+
+    void Trajectory::prepare() {
+        prepare(interp_method_);
+    }
+
+    bool Trajectory::is_prepared(Interp interp_method) const {
+        return interp_method == Interp::Linear || (coeffs_valid_ && coeffs_interp_ == interp_method);
+    }
+
+    void Trajectory::compute_spline(Interp interp_method) {
+        const std::size_t n = size();
+        coeffs_interp_ = interp_method;
+        coeffs_valid_ = true;
+        if (n < 2) {
+            coeffs_.clear();
+            return;
+        }
+        coeffs_.resize((n - 1) * path_dim_ * 4);
+        std::vector<double> h(n - 1);
+        bool degenerate = false;
+        for (std::size_t i = 0; i < n - 1; ++i) {
+            h[i] = (times_[i + 1] - times_[i]).as_seconds();
+            if (h[i] <= 0.0) {
+                degenerate = true;
+            }
+        }
+        // second derivatives at the knots, n x path_dim_
+        std::vector<double> M(n * path_dim_, 0.0);
+        if (degenerate) {
+            LOG(Warning) << "Cubic interpolation requires strictly increasing waypoint times. Using linear segments.";
+        }
+        else if (n > 2 || interp_method == Interp::CubicClamped) {
+            // Thomas algorithm on the tridiagonal system for M; the matrix depends
+            // only on the knot spacing, so one forward sweep serves all dimensions
+            const bool clamped = interp_method == Interp::CubicClamped;
+            const std::size_t first = clamped ? 0 : 1;
+            const std::size_t last  = clamped ? n - 1 : n - 2;
+            std::vector<double> c_prime(n, 0.0);
+            for (std::size_t i = first; i <= last; ++i) {
+                const double a = i > 0 ? h[i - 1] : 0.0;
+                const double c = i < n - 1 ? h[i] : 0.0;
+                double b = 2.0 * (a + c);
+                for (std::size_t j = 0; j < path_dim_; ++j) {
+                    const double y   = row(i)[j];
+                    // clamped ends have zero slope
+                    const double s_r = i < n - 1 ? (row(i + 1)[j] - y) / h[i] : 0.0;
+                    const double s_l = i > 0 ? (y - row(i - 1)[j]) / h[i - 1] : 0.0;
+                    double d = 6.0 * (s_r - s_l);
+                    if (i > first) {
+                        d -= a * M[(i - 1) * path_dim_ + j];
+                    }
+                    M[i * path_dim_ + j] = d;
+                }
+                if (i > first) {
+                    b -= a * c_prime[i - 1];
+                }
+                c_prime[i] = c / b;
+                for (std::size_t j = 0; j < path_dim_; ++j) {
+                    M[i * path_dim_ + j] /= b;
+                }
+            }
+            for (std::size_t i = last; i-- > first;) {
+                for (std::size_t j = 0; j < path_dim_; ++j) {
+                    M[i * path_dim_ + j] -= c_prime[i] * M[(i + 1) * path_dim_ + j];
+                }
+            }
+        }
+        for (std::size_t i = 0; i < n - 1; ++i) {
+            double *c = coeffs_.data() + i * path_dim_ * 4;
+            for (std::size_t j = 0; j < path_dim_; ++j, c += 4) {
+                const double y0 = row(i)[j];
+                const double y1 = row(i + 1)[j];
+                if (degenerate) {
+                    c[0] = y0;
+                    c[1] = h[i] > 0.0 ? (y1 - y0) / h[i] : 0.0;
+                    c[2] = 0.0;
+                    c[3] = 0.0;
+                    continue;
+                }
+                const double M0 = M[i * path_dim_ + j];
+                const double M1 = M[(i + 1) * path_dim_ + j];
+                c[0] = y0;
+                c[1] = (y1 - y0) / h[i] - h[i] * (2.0 * M0 + M1) / 6.0;
+                c[2] = 0.5 * M0;
+                c[3] = (M1 - M0) / (6.0 * h[i]);
+            }
+        }
+    }
+
+    std::size_t Trajectory::find_after(const Time &instant, std::size_t hint) const {
+        // callers guarantee times_.front() <= instant <= times_.back()
+        return detail::gallop_lower_bound(times_.data(), times_.size(), instant, hint);
+    }
+
+    void Trajectory::detect_uniform() {
+        uniform_ = false;
+        if (times_.size() < 2) {
+            return;
+        }
+        sample_period_ = (times_.back() - times_.front()).as_seconds() / (times_.size() - 1);
+        if (sample_period_ <= 0.0) {
+            return;
+        }
+        for (std::size_t i = 1; i < times_.size(); ++i) {
+            if (std::abs((times_[i] - times_.front()).as_seconds() - i * sample_period_) > UNIFORM_TOL) {
+                return;
+            }
+        }
+        uniform_ = true;
+    }
+
+    bool Trajectory::is_segment_valid(std::size_t index) const {
+        if (times_[index + 1] < times_[index]) {
+            return false;
+        }
+        if (times_[index + 1] == times_[index]) {
+            return true;
+        }
+        const double *p0 = row(index);
+        const double *p1 = row(index + 1);
+        const double dt = (times_[index + 1] - times_[index]).as_seconds();
+        for (std::size_t j = 0; j < path_dim_; ++j) {
+            double max_diff_j = j >= max_diff_.size() ? max_diff_.back() : max_diff_[j];
+            if (std::abs(p1[j] - p0[j]) / dt > max_diff_j) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Trajectory::update_segment(std::size_t index) {
+        assert(index < segment_valid_.size() && index + 1 < size());
+        const char valid = is_segment_valid(index) ? 1 : 0;
+        if (valid != segment_valid_[index]) {
+            if (valid) {
+                invalid_segments_--;
+            }
+            else {
+                invalid_segments_++;
+            }
+            segment_valid_[index] = valid;
+        }
+    }
+
+    void Trajectory::check_segments() {
+        segment_valid_.assign(size() > 0 ? size() - 1 : 0, 1);
+        invalid_segments_ = 0;
+        for (std::size_t i = 0; i < segment_valid_.size(); ++i) {
+            update_segment(i);
+        }
+    }
+
     bool Trajectory::check_max_diff() const {
         if (max_diff_.size() != path_dim_ && max_diff_.size() != 1){
             LOG(Warning) << "Input max_diff given to Trajectory must either be of size 1 or of size path_dim.";
@@ -215,17 +1091,15 @@ namespace robo {
     }
 
     bool Trajectory::check_waypoints() const {
-        Time t = waypoints_[0].when();
-        for (std::size_t i = 0; i < waypoints_.size(); ++i) {
-            if (waypoints_[i].get_dim() != path_dim_) {
-                LOG(Warning) << "Input waypoints given to Trajectory contains Points of the wrong size.";
-                return false;
-            }
-            if (waypoints_[i].when() < t) {
+        // positions are stored as one size() x path_dim_ block, so every waypoint
+        // has the correct dimension by construction
+        Time t = times_[0];
+        for (std::size_t i = 0; i < times_.size(); ++i) {
+            if (times_[i] < t) {
                 LOG(Warning) << "Input waypoint times must be monotonically increasing or not changing.";
                 return false;
             }
-            t = waypoints_[i].when();
+            t = times_[i];
         }
 
         if (!is_path_smooth()) {
@@ -243,11 +1117,14 @@ namespace robo {
         bool is_smooth = true;
 		std::size_t dim = 0;
 		std::size_t time_idx = 0;
-        for (std::size_t i = 0; i < waypoints_.size() - 1; ++i) {
-            if (waypoints_[i + 1].when() != waypoints_[i].when()) {
+        for (std::size_t i = 0; i < times_.size() - 1; ++i) {
+            if (times_[i + 1] != times_[i]) {
+                const double *p0 = row(i);
+                const double *p1 = row(i + 1);
+                const double dt = (times_[i + 1] - times_[i]).as_seconds();
                 for (std::size_t j = 0; j < path_dim_; ++j) {
 					double max_diff_j = j >= max_diff_.size() ? max_diff_.back() : max_diff_[j];
-                    if (std::abs(waypoints_[i + 1][j] - waypoints_[i][j]) / (waypoints_[i + 1].when().as_seconds() - waypoints_[i].when().as_seconds()) > max_diff_j) {
+                    if (std::abs(p1[j] - p0[j]) / dt > max_diff_j) {
                         is_smooth = false;
 						dim = j;
 						time_idx = i;
@@ -256,41 +1133,30 @@ namespace robo {
             }
         }
 		if (!is_smooth) {
-			LOG(Warning) << "Trajectory path does not satisfy required smoothness set by max_diff for dimension " << dim << " between times " << waypoints_[time_idx].when() << " and " <<  waypoints_[time_idx + 1].when();
+			LOG(Warning) << "Trajectory path does not satisfy required smoothness set by max_diff for dimension " << dim << " between times " << times_[time_idx] << " and " <<  times_[time_idx + 1];
 		}
         return is_smooth;
     }
 
     std::vector<WayPoint> Trajectory::linspace_points(const WayPoint& initial, const WayPoint& final, std::size_t n, bool include_initial, bool include_final) {
+        LinspaceRange range = linspace_range(initial, final, n, include_initial, include_final);
+        return std::vector<WayPoint>(range.begin(), range.end());
+    }
+
+    Trajectory::LinspaceRange Trajectory::linspace_range(const WayPoint& initial, const WayPoint& final, std::size_t n, bool include_initial, bool include_final) {
         if (initial.empty() || final.empty()) {
             LOG(Error) << "Input points given to Trajectory::linear_interpolate() cannot be empty.";
-            return { initial };
+            return LinspaceRange(initial, initial, 1, true, true);
         }
         if (initial.get_dim() != final.get_dim()) {
             LOG(Error) << "Input points given to Trajectory::linear_interpolate() must be of same size.";
-            return { initial };
-        }
-        if (!include_initial) {
-            n++;
-        }
-        if (!include_final) {
-            n++;
+            return LinspaceRange(initial, initial, 1, true, true);
         }
-        // std::vector<double> times = linspace(initial.when().as_seconds(), final.when().as_seconds(), n);
-        std::vector<double> times;
-        times.resize(n);
-        linspace(initial.when().as_seconds(), final.when().as_seconds(), times);
-        std::vector<WayPoint> interp_points(n);
-        for (std::size_t i = 0; i < n; ++i) {
-            interp_points[i] = linear_time_interpolate(initial, final, seconds(times[i]));
-        }
-        if (!include_initial) {
-            interp_points.erase(interp_points.begin());
-        }
-        if (!include_final) {
-            interp_points.pop_back();
-        }
-        return interp_points;
+        return LinspaceRange(initial, final, n, include_initial, include_final);
+    }
+
+    bool Trajectory::linspace_points(const WayPoint& initial, const WayPoint& final, std::size_t n, std::vector<Time>& times, Eigen::Ref<PositionMatrix> positions, bool include_initial, bool include_final) {
+        return linspace_range(initial, final, n, include_initial, include_final).write(times, positions);
     }
 
     WayPoint Trajectory::linear_time_interpolate(const WayPoint& initial, const WayPoint& final, const Time& t) {
@@ -302,21 +1168,63 @@ namespace robo {
             LOG(Error) << "Input points given to Trajectory::linear_time_interpolate() must be of same size.";
             return { initial };
         }
-        WayPoint interp_point;
         if (t <= initial.when()) {
             return { initial };
         }
         if (t >= final.when()) {
             return { final };
         }
+        WayPoint interp_point;
         interp_point.set_time(t);
         interp_point.resize(initial.get_dim());
-        for (std::size_t i = 0; i < initial.get_dim(); ++i) {
-            interp_point[i] = initial[i] + (t.as_seconds() - initial.when().as_seconds()) * (final[i] - initial[i]) / (final.when().as_seconds() - initial.when().as_seconds());
-        }
-        // std::cout << t.as_seconds() << ": " << (interp_point[0]) <<  ", " << final[0] << ", " << initial[0] << "\n";
+        time_interpolate(initial, final, t, interp_point.data());
         return interp_point;
     }
 
+    Trajectory::LinspaceRange::LinspaceRange(const WayPoint &initial, const WayPoint &final, std::size_t n, bool include_initial, bool include_final) :
+        initial_(initial),
+        final_(final),
+        size_(n),
+        offset_(include_initial ? 0 : 1),
+        count_(n + (include_initial ? 0 : 1) + (include_final ? 0 : 1))
+    {}
+
+    WayPoint Trajectory::LinspaceRange::operator[](std::size_t index) const {
+        const Time t = time(index);
+        if (t <= initial_.when()) {
+            return initial_;
+        }
+        if (t >= final_.when()) {
+            return final_;
+        }
+        WayPoint point;
+        point.set_time(t);
+        point.resize(initial_.get_dim());
+        time_interpolate(initial_, final_, t, point.data());
+        return point;
+    }
+
+    bool Trajectory::LinspaceRange::write(std::vector<Time> &times, Eigen::Ref<PositionMatrix> positions) const {
+        if (static_cast<std::size_t>(positions.rows()) != size_ || static_cast<std::size_t>(positions.cols()) != initial_.get_dim()) {
+            LOG(Warning) << "Output given to Trajectory::LinspaceRange::write() must be of size n x path_dim. Output not written.";
+            return false;
+        }
+        times.resize(size_);
+        for (std::size_t i = 0; i < size_; ++i) {
+            times[i] = time(i);
+            time_interpolate(initial_, final_, times[i], positions.row(i).data());
+        }
+        return true;
+    }
+
+    Time Trajectory::LinspaceRange::time(std::size_t index) const {
+        const double t0 = initial_.when().as_seconds();
+        const double t1 = final_.when().as_seconds();
+        if (count_ < 2) {
+            return seconds(t0);
+        }
+        return seconds(t0 + (t1 - t0) * static_cast<double>(index + offset_) / static_cast<double>(count_ - 1));
+    }
+
 }  // namespace robo
 }  // namespace mahi
\ No newline at end of file
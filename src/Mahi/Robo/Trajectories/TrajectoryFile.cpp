@@ -0,0 +1,404 @@
+#include <Mahi/Robo/Trajectories/TrajectoryFile.hpp>
+#include <Mahi/Robo/Trajectories/Search.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    namespace {
+        const char          TRAJ_MAGIC[8]  = { 'M', 'A', 'H', 'I', 'T', 'R', 'A', 'J' };
+        const std::uint32_t TRAJ_VERSION   = 1;
+        const std::uint32_t TRAJ_ENDIAN    = 0x01020304;
+        const std::size_t   TRAJ_COPY_SIZE = 1 << 16; // bytes moved per copy when finalizing
+    }
+
+    //==============================================================================
+    // TRAJECTORY WRITER
+    //==============================================================================
+
+    TrajectoryWriter::TrajectoryWriter() :
+        file_(nullptr),
+        times_file_(nullptr),
+        path_dim_(0),
+        count_(0),
+        last_time_(0)
+    {}
+
+    TrajectoryWriter::TrajectoryWriter(const std::string &filepath, std::size_t path_dim) :
+        TrajectoryWriter()
+    {
+        open(filepath, path_dim);
+    }
+
+    TrajectoryWriter::~TrajectoryWriter() {
+        if (is_open()) {
+            close();
+        }
+    }
+
+    bool TrajectoryWriter::open(const std::string &filepath, std::size_t path_dim) {
+        if (is_open()) {
+            close();
+        }
+        filepath_ = filepath;
+        path_dim_ = path_dim;
+        count_ = 0;
+        file_ = std::fopen(filepath_.c_str(), "wb");
+        times_file_ = std::fopen((filepath_ + ".times").c_str(), "w+b");
+        if (!file_ || !times_file_) {
+            LOG(Error) << "Failed to open " << filepath_ << " for writing trajectory.";
+            if (file_) {
+                std::fclose(file_);
+                file_ = nullptr;
+            }
+            if (times_file_) {
+                std::fclose(times_file_);
+                times_file_ = nullptr;
+                std::remove((filepath_ + ".times").c_str());
+            }
+            return false;
+        }
+        // reserve the header; it is finalized by close()
+        TrajectoryFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        return std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    }
+
+    bool TrajectoryWriter::write(const WayPoint &waypoint) {
+        if (!is_open()) {
+            LOG(Warning) << "Attempted to write to a TrajectoryWriter that is not open. WayPoint not written.";
+            return false;
+        }
+        if (waypoint.get_dim() != path_dim_) {
+            LOG(Warning) << "Input waypoint given to TrajectoryWriter contains wrong dimension. WayPoint not written.";
+            return false;
+        }
+        if (!write_time(waypoint.when())) {
+            return false;
+        }
+        if (std::fwrite(waypoint.data(), sizeof(double), path_dim_, file_) != path_dim_) {
+            LOG(Error) << "Failed to write waypoint to " << filepath_ << ".";
+            return false;
+        }
+        count_++;
+        return true;
+    }
+
+    bool TrajectoryWriter::write(const std::vector<Time> &times, const Eigen::Ref<const Trajectory::PositionMatrix> &positions) {
+        if (!is_open()) {
+            LOG(Warning) << "Attempted to write to a TrajectoryWriter that is not open. Chunk not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(positions.rows()) != times.size() || static_cast<std::size_t>(positions.cols()) != path_dim_) {
+            LOG(Warning) << "Chunk given to TrajectoryWriter must be times.size() x path_dim. Chunk not written.";
+            return false;
+        }
+        for (std::size_t i = 0; i < times.size(); ++i) {
+            if (!write_time(times[i])) {
+                return false;
+            }
+            if (std::fwrite(positions.row(i).data(), sizeof(double), path_dim_, file_) != path_dim_) {
+                LOG(Error) << "Failed to write waypoint to " << filepath_ << ".";
+                return false;
+            }
+            count_++;
+        }
+        return true;
+    }
+
+    bool TrajectoryWriter::close() {
+        if (!is_open()) {
+            return false;
+        }
+        bool success = true;
+        TrajectoryFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, TRAJ_MAGIC, sizeof(TRAJ_MAGIC));
+        header.version          = TRAJ_VERSION;
+        header.endian           = TRAJ_ENDIAN;
+        header.path_dim         = path_dim_;
+        header.count            = count_;
+        header.positions_offset = sizeof(TrajectoryFileHeader);
+        header.times_offset     = header.positions_offset + count_ * path_dim_ * sizeof(double);
+        // append the spooled time column after the positions
+        std::vector<char> buffer(TRAJ_COPY_SIZE);
+        std::rewind(times_file_);
+        std::size_t n;
+        while ((n = std::fread(buffer.data(), 1, buffer.size(), times_file_)) > 0) {
+            if (std::fwrite(buffer.data(), 1, n, file_) != n) {
+                success = false;
+                break;
+            }
+        }
+        std::fclose(times_file_);
+        times_file_ = nullptr;
+        std::remove((filepath_ + ".times").c_str());
+        if (std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+            success = false;
+        }
+        if (std::fclose(file_) != 0) {
+            success = false;
+        }
+        file_ = nullptr;
+        if (!success) {
+            LOG(Error) << "Failed to finalize trajectory file " << filepath_ << ".";
+        }
+        return success;
+    }
+
+    bool TrajectoryWriter::is_open() const {
+        return file_ != nullptr;
+    }
+
+    std::size_t TrajectoryWriter::size() const {
+        return static_cast<std::size_t>(count_);
+    }
+
+    bool TrajectoryWriter::save(const std::string &filepath, const Trajectory &trajectory) {
+        TrajectoryWriter writer;
+        if (!writer.open(filepath, trajectory.get_dim())) {
+            return false;
+        }
+        if (!writer.write(trajectory.times(), trajectory.positions())) {
+            writer.close();
+            return false;
+        }
+        return writer.close();
+    }
+
+    bool TrajectoryWriter::write_time(const Time &time) {
+        const std::int64_t us = time.as_microseconds();
+        if (count_ > 0 && us < last_time_) {
+            LOG(Warning) << "Waypoint times given to TrajectoryWriter must be monotonically increasing or not changing. WayPoint not written.";
+            return false;
+        }
+        if (std::fwrite(&us, sizeof(us), 1, times_file_) != 1) {
+            LOG(Error) << "Failed to write waypoint time for " << filepath_ << ".";
+            return false;
+        }
+        last_time_ = us;
+        return true;
+    }
+
+    //==============================================================================
+    // MAPPED TRAJECTORY
+    //==============================================================================
+
+    MappedTrajectory::MappedTrajectory() :
+        data_(nullptr),
+        length_(0),
+#ifdef _WIN32
+        file_handle_(INVALID_HANDLE_VALUE),
+        mapping_handle_(nullptr),
+#else
+        fd_(-1),
+#endif
+        path_dim_(0),
+        count_(0),
+        times_(nullptr),
+        positions_(nullptr)
+    {}
+
+    MappedTrajectory::MappedTrajectory(const std::string &filepath) :
+        MappedTrajectory()
+    {
+        open(filepath);
+    }
+
+    MappedTrajectory::~MappedTrajectory() {
+        close();
+    }
+
+    bool MappedTrajectory::open(const std::string &filepath) {
+        close();
+#ifdef _WIN32
+        file_handle_ = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_handle_ == INVALID_HANDLE_VALUE) {
+            LOG(Error) << "Failed to open trajectory file " << filepath << ".";
+            return false;
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle_, &file_size)) {
+            LOG(Error) << "Failed to read size of trajectory file " << filepath << ".";
+            close();
+            return false;
+        }
+        length_ = static_cast<std::size_t>(file_size.QuadPart);
+        if (length_ >= sizeof(TrajectoryFileHeader)) {
+            mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_handle_) {
+                data_ = MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0);
+            }
+        }
+#else
+        fd_ = ::open(filepath.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            LOG(Error) << "Failed to open trajectory file " << filepath << ".";
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            LOG(Error) << "Failed to read size of trajectory file " << filepath << ".";
+            close();
+            return false;
+        }
+        length_ = static_cast<std::size_t>(st.st_size);
+        if (length_ >= sizeof(TrajectoryFileHeader)) {
+            void *data = mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd_, 0);
+            data_ = data == MAP_FAILED ? nullptr : data;
+        }
+#endif
+        if (!data_) {
+            LOG(Error) << "Failed to map trajectory file " << filepath << ".";
+            close();
+            return false;
+        }
+        const TrajectoryFileHeader *header = static_cast<const TrajectoryFileHeader *>(data_);
+        if (std::memcmp(header->magic, TRAJ_MAGIC, sizeof(TRAJ_MAGIC)) != 0) {
+            LOG(Error) << "File " << filepath << " is not a trajectory file or was not closed properly.";
+            close();
+            return false;
+        }
+        if (header->version != TRAJ_VERSION || header->endian != TRAJ_ENDIAN) {
+            LOG(Error) << "Trajectory file " << filepath << " has an unsupported version or byte order.";
+            close();
+            return false;
+        }
+        // compare by division so that a corrupt count or dimension cannot wrap the
+        // byte counts around and pass
+        const std::uint64_t length = length_;
+        if (header->path_dim == 0 ||
+            header->positions_offset % sizeof(double) != 0 || header->times_offset % sizeof(std::int64_t) != 0 ||
+            header->positions_offset > length || header->times_offset > length ||
+            header->count > (length - header->times_offset) / sizeof(std::int64_t) ||
+            header->count > (length - header->positions_offset) / sizeof(double) / header->path_dim) {
+            LOG(Error) << "Trajectory file " << filepath << " is truncated or corrupt.";
+            close();
+            return false;
+        }
+        path_dim_  = static_cast<std::size_t>(header->path_dim);
+        count_     = static_cast<std::size_t>(header->count);
+        positions_ = reinterpret_cast<const double *>(static_cast<const char *>(data_) + header->positions_offset);
+        times_     = reinterpret_cast<const std::int64_t *>(static_cast<const char *>(data_) + header->times_offset);
+        return true;
+    }
+
+    void MappedTrajectory::close() {
+#ifdef _WIN32
+        if (data_) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_handle_) {
+            CloseHandle(mapping_handle_);
+            mapping_handle_ = nullptr;
+        }
+        if (file_handle_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_handle_);
+            file_handle_ = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (data_) {
+            munmap(data_, length_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+        data_      = nullptr;
+        length_    = 0;
+        path_dim_  = 0;
+        count_     = 0;
+        times_     = nullptr;
+        positions_ = nullptr;
+    }
+
+    bool MappedTrajectory::is_open() const {
+        return data_ != nullptr;
+    }
+
+    bool MappedTrajectory::empty() const {
+        return count_ == 0;
+    }
+
+    std::size_t MappedTrajectory::size() const {
+        return count_;
+    }
+
+    std::size_t MappedTrajectory::get_dim() const {
+        return path_dim_;
+    }
+
+    Time MappedTrajectory::time(std::size_t index) const {
+        if (index >= count_) {
+            LOG(Warning) << "Index for MappedTrajectory outside of range. Returning zero time.";
+            return Time::Zero;
+        }
+        return microseconds(times_[index]);
+    }
+
+    Eigen::Map<const Trajectory::PositionMatrix> MappedTrajectory::positions() const {
+        return Eigen::Map<const Trajectory::PositionMatrix>(positions_, count_, path_dim_);
+    }
+
+    std::vector<double> MappedTrajectory::at_time(const Time &instant) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to access an empty trajectory at a certain time. Returning empty vector.";
+            return std::vector<double>();
+        }
+        std::vector<double> position(path_dim_);
+        std::size_t cursor = 0;
+        at_time(instant, cursor, Eigen::Map<Eigen::VectorXd>(position.data(), path_dim_));
+        return position;
+    }
+
+    bool MappedTrajectory::at_time(const Time &instant, std::size_t &cursor, Eigen::Ref<Eigen::VectorXd> position) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to access an empty trajectory at a certain time. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(position.size()) != path_dim_) {
+            LOG(Warning) << "Output given to MappedTrajectory::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        const std::int64_t t = instant.as_microseconds();
+        if (t <= times_[0] || count_ == 1) {
+            position = Eigen::Map<const Eigen::VectorXd>(positions_, path_dim_);
+            return true;
+        }
+        if (t >= times_[count_ - 1]) {
+            position = Eigen::Map<const Eigen::VectorXd>(positions_ + (count_ - 1) * path_dim_, path_dim_);
+            return true;
+        }
+        const std::size_t after = detail::gallop_lower_bound(times_, count_, t, cursor);
+        const std::size_t before = after - 1;
+        cursor = after;
+        Eigen::Map<const Eigen::VectorXd> q0(positions_ + before * path_dim_, path_dim_);
+        Eigen::Map<const Eigen::VectorXd> q1(positions_ + after * path_dim_, path_dim_);
+        const double alpha = static_cast<double>(t - times_[before]) / static_cast<double>(times_[after] - times_[before]);
+        position = q0 + alpha * (q1 - q0);
+        return true;
+    }
+
+    Trajectory MappedTrajectory::to_trajectory() const {
+        std::vector<Time> times(count_);
+        for (std::size_t i = 0; i < count_; ++i) {
+            times[i] = microseconds(times_[i]);
+        }
+        return Trajectory(times, positions());
+    }
+
+}  // namespace robo
+}  // namespace mahi
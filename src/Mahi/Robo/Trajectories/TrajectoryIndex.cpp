@@ -0,0 +1,209 @@
+#include <Mahi/Robo/Trajectories/TrajectoryIndex.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <Mahi/Util/Math/Constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    namespace {
+        // maximum number of segments tested directly in a leaf node
+        const std::size_t LEAF_SEGMENTS = 8;
+
+        // depth limit of the traversal stack, far beyond a balanced tree over any path
+        const std::size_t MAX_DEPTH = 128;
+    }
+
+    TrajectoryIndex::TrajectoryIndex() :
+        trajectory_(nullptr),
+        path_dim_(0),
+        segments_(0)
+    {}
+
+    TrajectoryIndex::TrajectoryIndex(const Trajectory &trajectory) :
+        trajectory_(nullptr),
+        path_dim_(0),
+        segments_(0)
+    {
+        build(trajectory);
+    }
+
+    bool TrajectoryIndex::build(const Trajectory &trajectory) {
+        nodes_.clear();
+        bounds_.clear();
+        if (trajectory.empty()) {
+            LOG(Warning) << "Trajectory given to TrajectoryIndex is empty. Index not built.";
+            trajectory_ = nullptr;
+            path_dim_ = 0;
+            segments_ = 0;
+            return false;
+        }
+        trajectory_ = &trajectory;
+        path_dim_ = trajectory.get_dim();
+        // a single waypoint is indexed as one zero-length segment
+        segments_ = std::max<std::size_t>(trajectory.size() - 1, 1);
+        const std::size_t node_count = 2 * (segments_ / LEAF_SEGMENTS + 1);
+        nodes_.reserve(node_count);
+        bounds_.reserve(node_count * 2 * path_dim_);
+        build_node(0, segments_);
+        return true;
+    }
+
+    bool TrajectoryIndex::closest_point(const Eigen::Ref<const Eigen::VectorXd> &point, Projection &projection) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to query an empty TrajectoryIndex. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(point.size()) != path_dim_) {
+            LOG(Warning) << "Point given to TrajectoryIndex::closest_point() must be of size path_dim. Output not written.";
+            return false;
+        }
+        double best = INF;
+        search(point.data(), best, projection);
+        finish(best, projection);
+        return true;
+    }
+
+    bool TrajectoryIndex::closest_point_local(const Eigen::Ref<const Eigen::VectorXd> &point, std::size_t hint, std::size_t window, Projection &projection) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to query an empty TrajectoryIndex. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(point.size()) != path_dim_) {
+            LOG(Warning) << "Point given to TrajectoryIndex::closest_point_local() must be of size path_dim. Output not written.";
+            return false;
+        }
+        hint = std::min(hint, segments_ - 1);
+        const std::size_t begin = hint > window ? hint - window : 0;
+        const std::size_t end = std::min(hint + window + 1, segments_);
+        double best = INF;
+        test_segments(begin, end, point.data(), best, projection);
+        finish(best, projection);
+        return true;
+    }
+
+    bool TrajectoryIndex::empty() const {
+        return trajectory_ == nullptr;
+    }
+
+    std::size_t TrajectoryIndex::get_dim() const {
+        return path_dim_;
+    }
+
+    void TrajectoryIndex::search(const double *point, double &best, Projection &projection) const {
+        // depth-first branch and bound, nearer child first, with each node's box
+        // distance kept on the stack so it is computed once
+        std::size_t stack[MAX_DEPTH];
+        double stack_d2[MAX_DEPTH];
+        std::size_t top = 0;
+        stack[top] = 0;
+        stack_d2[top++] = box_distance2(0, point);
+        while (top > 0) {
+            --top;
+            if (stack_d2[top] >= best) {
+                continue;
+            }
+            const Node &node = nodes_[stack[top]];
+            if (node.left == 0) {
+                test_segments(node.begin, node.end, point, best, projection);
+                continue;
+            }
+            const double d_left = box_distance2(node.left, point);
+            const double d_right = box_distance2(node.right, point);
+            if (d_left < d_right) {
+                stack[top] = node.right;
+                stack_d2[top++] = d_right;
+                stack[top] = node.left;
+                stack_d2[top++] = d_left;
+            }
+            else {
+                stack[top] = node.left;
+                stack_d2[top++] = d_left;
+                stack[top] = node.right;
+                stack_d2[top++] = d_right;
+            }
+        }
+    }
+
+    void TrajectoryIndex::finish(double best, Projection &projection) const {
+        const std::size_t last = trajectory_->size() - 1;
+        const Time t0 = trajectory_->times()[projection.segment];
+        const Time t1 = trajectory_->times()[std::min(projection.segment + 1, last)];
+        projection.distance = std::sqrt(best);
+        projection.time = t0 + microseconds(static_cast<int64>(std::llround(projection.alpha * (t1 - t0).as_microseconds())));
+    }
+
+    std::size_t TrajectoryIndex::build_node(std::size_t begin, std::size_t end) {
+        const std::size_t index = nodes_.size();
+        Node node = { begin, end, 0, 0 };
+        nodes_.push_back(node);
+        bounds_.resize(bounds_.size() + 2 * path_dim_);
+        if (end - begin > LEAF_SEGMENTS) {
+            const std::size_t mid = begin + (end - begin) / 2;
+            const std::size_t left = build_node(begin, mid);
+            const std::size_t right = build_node(mid, end);
+            nodes_[index].left = left;
+            nodes_[index].right = right;
+            double *box = bounds_.data() + index * 2 * path_dim_;
+            const double *box_left = bounds_.data() + left * 2 * path_dim_;
+            const double *box_right = bounds_.data() + right * 2 * path_dim_;
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                box[j] = std::min(box_left[j], box_right[j]);
+                box[path_dim_ + j] = std::max(box_left[path_dim_ + j], box_right[path_dim_ + j]);
+            }
+            return index;
+        }
+        // a leaf bounds the waypoints of its segments
+        Eigen::Map<const Trajectory::PositionMatrix> positions = trajectory_->positions();
+        const std::size_t last = std::min(end, trajectory_->size() - 1);
+        double *box = bounds_.data() + index * 2 * path_dim_;
+        for (std::size_t j = 0; j < path_dim_; ++j) {
+            box[j] = positions.col(j).segment(begin, last - begin + 1).minCoeff();
+            box[path_dim_ + j] = positions.col(j).segment(begin, last - begin + 1).maxCoeff();
+        }
+        return index;
+    }
+
+    double TrajectoryIndex::box_distance2(std::size_t node, const double *point) const {
+        const double *lower = bounds_.data() + node * 2 * path_dim_;
+        const double *upper = lower + path_dim_;
+        double d2 = 0.0;
+        for (std::size_t j = 0; j < path_dim_; ++j) {
+            const double d = point[j] < lower[j] ? lower[j] - point[j] : (point[j] > upper[j] ? point[j] - upper[j] : 0.0);
+            d2 += d * d;
+        }
+        return d2;
+    }
+
+    void TrajectoryIndex::test_segments(std::size_t begin, std::size_t end, const double *point, double &best, Projection &projection) const {
+        const double *positions = trajectory_->positions().data();
+        const std::size_t last = trajectory_->size() - 1;
+        for (std::size_t i = begin; i < end; ++i) {
+            const double *p0 = positions + i * path_dim_;
+            const double *p1 = positions + std::min(i + 1, last) * path_dim_;
+            // project onto the segment, clamped to its end points
+            double dot = 0.0, length2 = 0.0;
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                const double d = p1[j] - p0[j];
+                dot += (point[j] - p0[j]) * d;
+                length2 += d * d;
+            }
+            const double alpha = length2 > 0.0 ? std::min(std::max(dot / length2, 0.0), 1.0) : 0.0;
+            double d2 = 0.0;
+            for (std::size_t j = 0; j < path_dim_; ++j) {
+                const double e = point[j] - (p0[j] + alpha * (p1[j] - p0[j]));
+                d2 += e * e;
+            }
+            if (d2 < best) {
+                best = d2;
+                projection.segment = i;
+                projection.alpha = alpha;
+            }
+        }
+    }
+
+}  // namespace robo
+}  // namespace mahi
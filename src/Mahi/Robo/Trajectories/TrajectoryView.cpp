@@ -0,0 +1,180 @@
+#include <Mahi/Robo/Trajectories/TrajectoryView.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <algorithm>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    TrajectoryView::TrajectoryView() :
+        path_dim_(0)
+    {}
+
+    TrajectoryView::TrajectoryView(const Trajectory &trajectory) :
+        path_dim_(trajectory.get_dim())
+    {
+        if (trajectory.empty()) {
+            LOG(Warning) << "Trajectory given to TrajectoryView is empty. View is empty.";
+            path_dim_ = 0;
+            return;
+        }
+        Piece piece;
+        piece.trajectory = &trajectory;
+        piece.start = trajectory.times().front();
+        piece.end = trajectory.times().back();
+        piece.offset = Time::Zero;
+        pieces_.push_back(piece);
+    }
+
+    TrajectoryView TrajectoryView::slice(const Time &from, const Time &to) const {
+        TrajectoryView view;
+        if (to < from) {
+            LOG(Warning) << "Slice end given to TrajectoryView::slice() is before its start. Returning empty view.";
+            return view;
+        }
+        for (std::size_t i = 0; i < pieces_.size(); ++i) {
+            if (pieces_[i].end < from || pieces_[i].start > to) {
+                continue;
+            }
+            Piece piece = pieces_[i];
+            piece.start = std::max(piece.start, from);
+            piece.end = std::min(piece.end, to);
+            view.pieces_.push_back(piece);
+        }
+        if (view.pieces_.empty()) {
+            LOG(Warning) << "Slice given to TrajectoryView::slice() is outside of the view. Returning empty view.";
+            return view;
+        }
+        view.path_dim_ = path_dim_;
+        return view;
+    }
+
+    TrajectoryView TrajectoryView::shift(const Time &offset) const {
+        TrajectoryView view(*this);
+        for (std::size_t i = 0; i < view.pieces_.size(); ++i) {
+            view.pieces_[i].start += offset;
+            view.pieces_[i].end += offset;
+            view.pieces_[i].offset += offset;
+        }
+        return view;
+    }
+
+    bool TrajectoryView::append(const TrajectoryView &next) {
+        if (next.empty()) {
+            return true;
+        }
+        if (empty()) {
+            *this = next;
+            return true;
+        }
+        if (next.path_dim_ != path_dim_) {
+            LOG(Warning) << "View given to TrajectoryView::append() has a different dimension. View not appended.";
+            return false;
+        }
+        const Time delay = end_time() - next.start_time();
+        for (std::size_t i = 0; i < next.pieces_.size(); ++i) {
+            Piece piece = next.pieces_[i];
+            piece.start += delay;
+            piece.end += delay;
+            piece.offset += delay;
+            pieces_.push_back(piece);
+        }
+        return true;
+    }
+
+    bool TrajectoryView::append(const Trajectory &next) {
+        return append(TrajectoryView(next));
+    }
+
+    std::vector<double> TrajectoryView::at_time(const Time &instant, Trajectory::Interp interp_method) const {
+        Eigen::VectorXd position = Eigen::VectorXd::Zero(path_dim_);
+        Cursor cursor;
+        at_time(instant, cursor, position, interp_method);
+        return std::vector<double>(position.data(), position.data() + position.size());
+    }
+
+    bool TrajectoryView::at_time(const Time &instant, Cursor &cursor, Eigen::Ref<Eigen::VectorXd> position, Trajectory::Interp interp_method) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to get a value from an empty TrajectoryView. Output not written.";
+            return false;
+        }
+        const std::size_t index = find_piece(instant, cursor.piece);
+        if (index != cursor.piece) {
+            cursor.piece = index;
+            cursor.index = 0;
+        }
+        const Piece &piece = pieces_[index];
+        const Time t = std::min(std::max(instant, piece.start), piece.end) - piece.offset;
+        return piece.trajectory->at_time(t, cursor.index, position, interp_method);
+    }
+
+    bool TrajectoryView::at_time(const Time &instant, Cursor &cursor, Eigen::Ref<Eigen::VectorXd> position, Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration, Trajectory::Interp interp_method) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to get a value from an empty TrajectoryView. Output not written.";
+            return false;
+        }
+        const std::size_t index = find_piece(instant, cursor.piece);
+        if (index != cursor.piece) {
+            cursor.piece = index;
+            cursor.index = 0;
+        }
+        const Piece &piece = pieces_[index];
+        const Time t = std::min(std::max(instant, piece.start), piece.end) - piece.offset;
+        if (!piece.trajectory->at_time(t, cursor.index, position, velocity, acceleration, interp_method)) {
+            return false;
+        }
+        if (instant < start_time() || instant > end_time()) {
+            // the view holds its end points at rest outside of its time range
+            velocity.setZero();
+            acceleration.setZero();
+        }
+        return true;
+    }
+
+    Time TrajectoryView::start_time() const {
+        return empty() ? Time::Zero : pieces_.front().start;
+    }
+
+    Time TrajectoryView::end_time() const {
+        return empty() ? Time::Zero : pieces_.back().end;
+    }
+
+    bool TrajectoryView::empty() const {
+        return pieces_.empty();
+    }
+
+    std::size_t TrajectoryView::pieces() const {
+        return pieces_.size();
+    }
+
+    std::size_t TrajectoryView::get_dim() const {
+        return path_dim_;
+    }
+
+    std::size_t TrajectoryView::find_piece(const Time &instant, std::size_t hint) const {
+        // playback usually stays in the same piece or moves on to the next one
+        if (hint < pieces_.size() && (hint == 0 || instant > pieces_[hint - 1].end)) {
+            if (instant <= pieces_[hint].end) {
+                return hint;
+            }
+            if (hint + 1 < pieces_.size() && instant <= pieces_[hint + 1].end) {
+                return hint + 1;
+            }
+        }
+        std::size_t lo = 0;
+        std::size_t hi = pieces_.size() - 1;
+        while (lo < hi) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (pieces_[mid].end < instant) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+}  // namespace robo
+}  // namespace mahi
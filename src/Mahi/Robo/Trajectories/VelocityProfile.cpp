@@ -0,0 +1,252 @@
+#include <Mahi/Robo/Trajectories/VelocityProfile.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <Mahi/Util/Math/Constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace robo {
+
+    VelocityProfile::VelocityProfile() :
+        shape_(Trapezoidal),
+        path_dim_(0),
+        t0_(Time::Zero),
+        T_(0.0),
+        num_phases_(0)
+    {}
+
+    VelocityProfile::VelocityProfile(Shape shape, const WayPoint &start, const std::vector<double> &goal, const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk) :
+        shape_(shape),
+        path_dim_(0),
+        t0_(Time::Zero),
+        T_(0.0),
+        num_phases_(0)
+    {
+        plan(shape, start, goal, max_velocity, max_acceleration, max_jerk);
+    }
+
+    bool VelocityProfile::plan(Shape shape, const WayPoint &start, const std::vector<double> &goal, const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration, const std::vector<double> &max_jerk) {
+        const std::size_t dim = start.get_dim();
+        if (goal.size() != dim || max_velocity.size() != dim || max_acceleration.size() != dim ||
+            (shape == SCurve && max_jerk.size() != dim)) {
+            LOG(Warning) << "Path dimensions of input parameters to VelocityProfile::plan() are inconsistent. Move not planned.";
+            return false;
+        }
+        // limits on s(t) in [0, 1], where dimension i moves distance_[i] * s
+        double v = INF, a = INF, j = INF;
+        for (std::size_t i = 0; i < dim; ++i) {
+            const bool jerk_ok = shape != SCurve || (max_jerk[i] > 0.0 && max_jerk[i] < INF);
+            if (!(max_velocity[i] > 0.0 && max_velocity[i] < INF && max_acceleration[i] > 0.0 && max_acceleration[i] < INF && jerk_ok)) {
+                LOG(Warning) << "Limits given to VelocityProfile::plan() must be positive and finite. Move not planned.";
+                return false;
+            }
+            const double D = std::abs(goal[i] - start[i]);
+            if (D > 0.0) {
+                v = std::min(v, max_velocity[i] / D);
+                a = std::min(a, max_acceleration[i] / D);
+                if (shape == SCurve) {
+                    j = std::min(j, max_jerk[i] / D);
+                }
+            }
+        }
+
+        shape_ = shape;
+        path_dim_ = dim;
+        t0_ = start.when();
+        q_0_ = Eigen::Map<const Eigen::VectorXd>(start.data(), dim);
+        distance_ = Eigen::Map<const Eigen::VectorXd>(goal.data(), dim) - q_0_;
+        T_ = 0.0;
+        num_phases_ = 0;
+        if (v == INF) {
+            // already at the goal
+            return true;
+        }
+
+        if (shape == Trapezoidal) {
+            if (v * v >= a) {
+                // never reaches the velocity limit
+                v = std::sqrt(a);
+            }
+            const double Ta = v / a;
+            const double Tv = std::max((1.0 - v * Ta) / v, 0.0);
+            push_phase(Ta, a, 0.0);
+            push_phase(Tv, 0.0, 0.0);
+            push_phase(Ta, -a, 0.0);
+        }
+        else {
+            // Tj: each jerk ramp, Ta: the whole speed-up, Tv: the cruise
+            double Tj, Ta;
+            if (v * j >= a * a) {
+                Tj = a / j;
+                Ta = v / a + Tj;
+            }
+            else {
+                Tj = std::sqrt(v / j);
+                Ta = 2.0 * Tj;
+            }
+            if (v * Ta >= 1.0) {
+                // too short to cruise, so lower the peak velocity until the speed-up
+                // and slow-down meet in the middle
+                v = 0.5 * (std::sqrt(a * a * a * a / (j * j) + 4.0 * a) - a * a / j);
+                if (v * j >= a * a) {
+                    Tj = a / j;
+                    Ta = v / a + Tj;
+                }
+                else {
+                    v = std::cbrt(j / 4.0);
+                    Tj = std::sqrt(v / j);
+                    Ta = 2.0 * Tj;
+                }
+            }
+            const double Tv = std::max((1.0 - v * Ta) / v, 0.0);
+            const double a_peak = j * Tj;
+            push_phase(Tj, 0.0, j);
+            push_phase(Ta - 2.0 * Tj, a_peak, 0.0);
+            push_phase(Tj, a_peak, -j);
+            push_phase(Tv, 0.0, 0.0);
+            push_phase(Tj, 0.0, -j);
+            push_phase(Ta - 2.0 * Tj, -a_peak, 0.0);
+            push_phase(Tj, -a_peak, j);
+        }
+        return true;
+    }
+
+    std::vector<double> VelocityProfile::at_time(const Time &instant) const {
+        std::vector<double> position(path_dim_);
+        if (empty()) {
+            LOG(Warning) << "Attempted to evaluate an empty VelocityProfile. Returning empty vector.";
+            return position;
+        }
+        double s, s_dot, s_ddot;
+        evaluate(instant, s, s_dot, s_ddot);
+        Eigen::Map<Eigen::VectorXd>(position.data(), path_dim_) = q_0_ + s * distance_;
+        return position;
+    }
+
+    bool VelocityProfile::at_time(const Time &instant, Eigen::Ref<Eigen::VectorXd> position) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to evaluate an empty VelocityProfile. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(position.size()) != path_dim_) {
+            LOG(Warning) << "Output given to VelocityProfile::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        double s, s_dot, s_ddot;
+        evaluate(instant, s, s_dot, s_ddot);
+        position = q_0_ + s * distance_;
+        return true;
+    }
+
+    bool VelocityProfile::at_time(const Time &instant, Eigen::Ref<Eigen::VectorXd> position, Eigen::Ref<Eigen::VectorXd> velocity, Eigen::Ref<Eigen::VectorXd> acceleration) const {
+        if (empty()) {
+            LOG(Warning) << "Attempted to evaluate an empty VelocityProfile. Output not written.";
+            return false;
+        }
+        if (static_cast<std::size_t>(position.size()) != path_dim_ || static_cast<std::size_t>(velocity.size()) != path_dim_ ||
+            static_cast<std::size_t>(acceleration.size()) != path_dim_) {
+            LOG(Warning) << "Outputs given to VelocityProfile::at_time() must be of size path_dim. Output not written.";
+            return false;
+        }
+        double s, s_dot, s_ddot;
+        evaluate(instant, s, s_dot, s_ddot);
+        position = q_0_ + s * distance_;
+        velocity = s_dot * distance_;
+        acceleration = s_ddot * distance_;
+        return true;
+    }
+
+    Trajectory VelocityProfile::trajectory(const Time &sample_period) const {
+        if (empty() || sample_period <= Time::Zero) {
+            LOG(Warning) << "VelocityProfile needs a move and a positive sample period to be sampled. Returning empty Trajectory.";
+            return Trajectory();
+        }
+        // samples every sample_period, plus the goal if the duration is not a
+        // multiple of it
+        const int64 duration = (end_time() - t0_).as_microseconds();
+        const int64 period = sample_period.as_microseconds();
+        std::size_t count = static_cast<std::size_t>(duration / period) + 1;
+        if (duration % period != 0) {
+            ++count;
+        }
+        std::vector<Time> times(count);
+        Trajectory::PositionMatrix positions(count, path_dim_);
+        for (std::size_t i = 0; i < count; ++i) {
+            times[i] = t0_ + microseconds(std::min(static_cast<int64>(i) * period, duration));
+            double s, s_dot, s_ddot;
+            evaluate(times[i], s, s_dot, s_ddot);
+            positions.row(i) = (q_0_ + s * distance_).transpose();
+        }
+        Trajectory trajectory;
+        trajectory.set_waypoints(times, positions);
+        return trajectory;
+    }
+
+    Time VelocityProfile::start_time() const {
+        return t0_;
+    }
+
+    Time VelocityProfile::end_time() const {
+        return t0_ + microseconds(static_cast<int64>(std::ceil(T_ * 1e6 - 1e-3)));
+    }
+
+    VelocityProfile::Shape VelocityProfile::get_shape() const {
+        return shape_;
+    }
+
+    bool VelocityProfile::empty() const {
+        return path_dim_ == 0;
+    }
+
+    std::size_t VelocityProfile::get_dim() const {
+        return path_dim_;
+    }
+
+    void VelocityProfile::clear() {
+        path_dim_ = 0;
+        T_ = 0.0;
+        num_phases_ = 0;
+        q_0_.resize(0);
+        distance_.resize(0);
+    }
+
+    void VelocityProfile::push_phase(double duration, double acceleration, double jerk) {
+        Phase phase = { T_, 0.0, 0.0, acceleration, jerk };
+        if (num_phases_ > 0) {
+            // integrate the previous phase to its end
+            const Phase &last = phases_[num_phases_ - 1];
+            const double t = T_ - last.start;
+            phase.s = last.s + t * (last.v + t * (last.a / 2 + t * last.j / 6));
+            phase.v = last.v + t * (last.a + t * last.j / 2);
+        }
+        phases_[num_phases_++] = phase;
+        T_ += duration;
+    }
+
+    void VelocityProfile::evaluate(const Time &instant, double &s, double &s_dot, double &s_ddot) const {
+        const double t = (instant - t0_).as_seconds();
+        // outside of the move the end points are held at rest
+        if (num_phases_ == 0 || t >= T_) {
+            s = num_phases_ == 0 ? 0.0 : 1.0;
+            s_dot = s_ddot = 0.0;
+            return;
+        }
+        if (t <= 0.0) {
+            s = s_dot = s_ddot = 0.0;
+            return;
+        }
+        std::size_t k = num_phases_ - 1;
+        while (k > 0 && phases_[k].start > t) {
+            --k;
+        }
+        const Phase &phase = phases_[k];
+        const double tau = t - phase.start;
+        s = phase.s + tau * (phase.v + tau * (phase.a / 2 + tau * phase.j / 6));
+        s_dot = phase.v + tau * (phase.a + tau * phase.j / 2);
+        s_ddot = phase.a + tau * phase.j;
+    }
+
+}  // namespace robo
+}  // namespace mahi
@@ -6,41 +6,63 @@ using namespace mahi::util;
 namespace mahi {
 namespace robo {
 
+    const std::size_t WayPoint::INLINE_DIM;
+
     WayPoint::WayPoint() :
         path_dim_(0)
     {}
 
     WayPoint::WayPoint(const Time &time, const std::vector<double> &position) :
         time_(time),
-        pos_(position),
-        path_dim_(position.size())
-    {}
+        path_dim_(0)
+    {
+        set_pos(position.data(), position.size());
+    }
+
+    WayPoint::WayPoint(const Time &time, const double *position, std::size_t path_dim) :
+        time_(time),
+        path_dim_(0)
+    {
+        set_pos(position, path_dim);
+    }
 
     const Time& WayPoint::when() const {
         return time_;
     }
 
-    const std::vector<double>& WayPoint::get_pos() const {
-        return pos_;
+    Eigen::Map<const Eigen::VectorXd> WayPoint::position() const {
+        return Eigen::Map<const Eigen::VectorXd>(data(), path_dim_);
+    }
+
+    std::vector<double> WayPoint::get_pos() const {
+        return std::vector<double>(data(), data() + path_dim_);
+    }
+
+    const double* WayPoint::data() const {
+        return path_dim_ > INLINE_DIM ? heap_pos_.data() : inline_pos_.data();
+    }
+
+    double* WayPoint::data() {
+        return path_dim_ > INLINE_DIM ? heap_pos_.data() : inline_pos_.data();
     }
 
 	std::vector<double> WayPoint::get_point() const {
 		std::vector<double> point(path_dim_ + 1);
 		point[0] = time_.as_seconds();
-		std::copy(pos_.begin(), pos_.end(), point.begin() + 1);
+		std::copy(data(), data() + path_dim_, point.begin() + 1);
 		return point;
 	}
 
     const double& WayPoint::operator[](std::size_t index) const {
-        return pos_[index];
+        return data()[index];
     }
 
     double& WayPoint::operator[](std::size_t index) {
-        return pos_[index];
+        return data()[index];
     }
 
     bool WayPoint::empty() const {
-        return pos_.empty();
+        return path_dim_ == 0;
     }
 
     WayPoint WayPoint::set_time(const Time& time) {
@@ -49,13 +71,37 @@ namespace robo {
     }
 
     void WayPoint::resize(std::size_t path_dim) {
+        if (path_dim > INLINE_DIM) {
+            if (path_dim_ <= INLINE_DIM) {
+                heap_pos_.assign(inline_pos_.begin(), inline_pos_.begin() + path_dim_);
+            }
+            heap_pos_.resize(path_dim);
+        }
+        else {
+            if (path_dim_ > INLINE_DIM) {
+                std::copy(heap_pos_.begin(), heap_pos_.begin() + path_dim, inline_pos_.begin());
+                heap_pos_.clear();
+            }
+            else if (path_dim > path_dim_) {
+                std::fill(inline_pos_.begin() + path_dim_, inline_pos_.begin() + path_dim, 0.0);
+            }
+        }
         path_dim_ = path_dim;
-        pos_.resize(path_dim);
     }
 
     WayPoint WayPoint::set_pos(const std::vector<double>& pos) {
-        pos_ = pos;
-        path_dim_ = pos.size();
+		return set_pos(pos.data(), pos.size());
+    }
+
+    WayPoint WayPoint::set_pos(const double *pos, std::size_t path_dim) {
+        if (path_dim > INLINE_DIM) {
+            heap_pos_.assign(pos, pos + path_dim);
+        }
+        else {
+            std::copy(pos, pos + path_dim, inline_pos_.begin());
+            heap_pos_.clear();
+        }
+        path_dim_ = path_dim;
 		return *this;
     }
 
@@ -66,12 +112,16 @@ namespace robo {
     void WayPoint::clear() {
         path_dim_ = 0;
         time_ = Time::Zero;
-        pos_.clear();
+        heap_pos_.clear();
     }
 
 	std::ostream& operator<<(std::ostream& os, const WayPoint& waypoint) {
-		return os << waypoint.when() << "\t" << waypoint.get_pos();
+		os << waypoint.when();
+		for (std::size_t i = 0; i < waypoint.get_dim(); ++i) {
+			os << "\t" << waypoint[i];
+		}
+		return os;
 	}
 
 }  // namespace robo
-}  // namespace mahi
\ No newline at end of file
+}  // namespace mahi